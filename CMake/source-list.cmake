@@ -25,12 +25,22 @@ set(CXX_FILES
 	src/Registry/Util/RayCast/RayCast.cpp
 	src/Registry/Util/RayCast/Offsets.h
 
+	src/Registry/Util/ByteStream.h
 	src/Registry/Util/CellCrawler.h
+	src/Registry/Util/CellGrid.h
+	src/Registry/Util/Clearance.h
 	src/Registry/Util/Combinatorics.h
+	src/Registry/Util/FaceFrame.h
+	src/Registry/Util/Interaction.h
+	src/Registry/Util/InteractionRecord.h
+	src/Registry/Util/Nearest.h
+	src/Registry/Util/NodeNames.h
 	src/Registry/Util/Premutation.h
 	src/Registry/Util/RayCast.h
+	src/Registry/Util/SceneGraph.h
 	src/Registry/Util/Scale.h
 	src/Registry/Util/Scale.cpp
+	src/Registry/Util/StatsRecord.h
 
 	src/Registry/Define/Fragment.h
 	src/Registry/Define/Fragment.cpp
@@ -7,6 +7,7 @@
 #pragma warning(pop)
 
 #include <atomic>
+#include <execution>
 #include <glm/glm.hpp>
 #include <ranges>
 #include <unordered_map>
@@ -139,10 +140,14 @@ namespace stl
 		if (!a_intfc->ReadRecordData(size)) {
 			return false;
 		}
-		a_str.reserve(size);
+		if (size == 0) {
+			return false;
+		}
+		a_str.resize(size);
 		if (!a_intfc->ReadRecordData(a_str.data(), static_cast<std::uint32_t>(size))) {
 			return false;
 		}
+		a_str.resize(size - 1);	 // write_string includes the terminator
 		return true;
 	}
 
@@ -12,11 +12,18 @@ namespace Papyrus::ActorLibrary
 			a_vm->TraceStack("Cannot validate a none reference", a_stackID);
 			return -1;
 		}
-		const auto code = Registry::IsValidActorImpl(a_actor);
+		const auto code = Registry::IsValidActorCached(a_actor);
 		// Gotta do some number tweaking to stay consistent on the papyrus sade
 		return code == 0 ? -2 : code;
 	}
 
+	std::vector<int32_t> GetValidationCounters(RE::StaticFunctionTag*)
+	{
+		const auto counters = Registry::GetValidityCounters();
+		const auto clamp = [](uint64_t a_value) { return static_cast<int32_t>(std::min<uint64_t>(a_value, std::numeric_limits<int32_t>::max())); };
+		return { clamp(counters.hits), clamp(counters.recomputes) };
+	}
+
 	void WriteStrip(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESForm* a_form, bool a_neverstrip)
 	{
 		if (!a_form) {
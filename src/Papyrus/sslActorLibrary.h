@@ -3,6 +3,7 @@
 namespace Papyrus::ActorLibrary
 {
 	int32_t ValidateActorImpl(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
+	std::vector<int32_t> GetValidationCounters(RE::StaticFunctionTag*);
 
 	void WriteStrip(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESForm* a_form, bool a_neverstrip);
 	void EraseStrip(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESForm* a_form);
@@ -16,6 +17,7 @@ namespace Papyrus::ActorLibrary
 	inline bool Register(VM* a_vm)
 	{
 		REGISTERFUNC(ValidateActorImpl, "sslActorLibrary", true);
+		REGISTERFUNC(GetValidationCounters, "sslActorLibrary", true);
 
 		REGISTERFUNC(WriteStrip, "sslActorLibrary", true);
 		REGISTERFUNC(EraseStrip, "sslActorLibrary", true);
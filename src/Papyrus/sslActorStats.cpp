@@ -13,20 +13,23 @@ namespace Papyrus::ActorStats
 
 	std::vector<RE::Actor*> GetAllTrackedUniqueActorsSorted(RE::StaticFunctionTag*)
 	{
-		auto tracked = Registry::Statistics::StatisticsData::GetSingleton()->GetTrackedActors();
-		std::erase_if(tracked, [](RE::Actor* act) {
-			const auto base = act->GetActorBase();
-			return !base || !base->IsUnique();
-		});
-		std::ranges::sort(tracked, [](RE::Actor* a, RE::Actor* b) {
-			if (a->IsPlayerRef())
-				return true;
-			if (b->IsPlayerRef())
-				return false;
+		const auto statdata = Registry::Statistics::StatisticsData::GetSingleton();
+		return statdata->GetTrackedUniqueActors(0, statdata->GetTrackedUniqueActorCount());
+	}
 
-			return std::strcmp(a->GetDisplayFullName(), b->GetDisplayFullName()) < 0;
-		});
-		return tracked;
+	std::vector<RE::Actor*> GetTrackedUniqueActorsPage(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, int a_page, int a_pagesize)
+	{
+		if (a_page < 0 || a_pagesize <= 0) {
+			a_vm->TraceStack(fmt::format("Invalid page {} of size {}", a_page, a_pagesize).c_str(), a_stackID);
+			return {};
+		}
+		const auto offset = static_cast<size_t>(a_page) * static_cast<size_t>(a_pagesize);
+		return Registry::Statistics::StatisticsData::GetSingleton()->GetTrackedUniqueActors(offset, static_cast<size_t>(a_pagesize));
+	}
+
+	int GetTrackedUniqueActorCount(RE::StaticFunctionTag*)
+	{
+		return static_cast<int>(Registry::Statistics::StatisticsData::GetSingleton()->GetTrackedUniqueActorCount());
 	}
 
 	void SetStatistic(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int id, float a_value)
@@ -40,7 +43,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Invalid Stat ID", a_stackID);
 			return;
 		}
-		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).SetStatistic(StatID(id), a_value);
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->SetStatistic(StatID(id), a_value);
 	}
 
 	float GetStatistic(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int id)
@@ -54,7 +57,46 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Invalid Stat ID", a_stackID);
 			return 0;
 		}
-		return Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).GetStatistic(StatID(id));
+		return Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetStatistic(StatID(id));
+	}
+
+	std::vector<float> GetAllStatistics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor)
+	{
+		using StatID = Registry::Statistics::ActorStats::StatisticID;
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return std::vector<float>(StatID::Total);
+		}
+		const auto stats = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor);
+		const auto ret = stats->GetAllStatistics();
+		return std::vector<float>{ ret.begin(), ret.end() };
+	}
+
+	std::vector<float> GetStatisticsMatrix(RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors)
+	{
+		return Registry::Statistics::StatisticsData::GetSingleton()->GetStatisticMatrix(a_actors);
+	}
+
+	void AddStatistics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors, std::vector<int> a_ids, std::vector<float> a_values)
+	{
+		using StatID = Registry::Statistics::ActorStats::StatisticID;
+		if (a_actors.size() != a_ids.size() || a_actors.size() != a_values.size()) {
+			a_vm->TraceStack("Actor, id and value arrays must be of equal length", a_stackID);
+			return;
+		}
+		std::vector<Registry::Statistics::StatisticDelta> deltas{};
+		deltas.reserve(a_actors.size());
+		for (size_t i = 0; i < a_actors.size(); i++) {
+			if (!a_actors[i]) {
+				a_vm->TraceStack(fmt::format("Actor at index {} is none", i).c_str(), a_stackID);
+				continue;
+			} else if (a_ids[i] < 0 || a_ids[i] >= StatID::Total) {
+				a_vm->TraceStack(fmt::format("Invalid Stat ID {} at index {}", a_ids[i], i).c_str(), a_stackID);
+				continue;
+			}
+			deltas.emplace_back(a_actors[i], StatID(a_ids[i]), a_values[i]);
+		}
+		Registry::Statistics::StatisticsData::GetSingleton()->AddStatistics(deltas);
 	}
 
 	int GetSexuality(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor)
@@ -63,8 +105,8 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return 0;
 		}
-		const auto& stats = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor);
-		const auto value = stats.GetStatistic(stats.Sexuality);
+		const auto stats = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor);
+		const auto value = stats->GetStatistic(stats->Sexuality);
 		return MapSexuality(nullptr, value);
 	}
 
@@ -74,25 +116,25 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return;
 		}
-		auto& stats = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor);
+		auto stats = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor);
 		switch (mapping) {
 		case 0:
 			{
 				float value = static_cast<float>(100 - (Settings::fPercentageHetero / 2));
-				stats.SetStatistic(stats.Sexuality, value);
+				stats->SetStatistic(stats->Sexuality, value);
 			}
 			break;
 		case 1:
 			{
 				float value = static_cast<float>(Settings::fPercentageHomo / 2);
-				stats.SetStatistic(stats.Sexuality, value);
+				stats->SetStatistic(stats->Sexuality, value);
 			}
 			break;
 		case 2:
 			{
 				float range = 100.0f - Settings::fPercentageHetero - Settings::fPercentageHomo;
 				float value = Settings::fPercentageHomo + range / 2;
-				stats.SetStatistic(stats.Sexuality, value);
+				stats->SetStatistic(stats->Sexuality, value);
 			}
 			break;
 		}
@@ -119,7 +161,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return {};
 		}
-		return Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).GetEveryCustomID();
+		return Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetEveryCustomID();
 	}
 
 	bool HasCustomStat(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat)
@@ -128,7 +170,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return false;
 		}
-		return Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).HasCustom(a_stat);
+		return Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->HasCustom(a_stat);
 	}
 
 	void SetCustomStatFlt(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat, float a_value)
@@ -137,7 +179,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return;
 		}
-		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).SetCustomFlt(a_stat, a_value);
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->SetCustomFlt(a_stat, a_value);
 	}
 
 	void SetCustomStatStr(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat, RE::BSFixedString a_value)
@@ -146,7 +188,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return;
 		}
-		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).SetCustomStr(a_stat, a_value);
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->SetCustomStr(a_stat, a_value);
 	}
 
 	float GetCustomStatFlt(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat, float a_default)
@@ -155,7 +197,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return a_default;
 		}
-		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).GetCustomFlt(a_stat);
+		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetCustomFlt(a_stat);
 		return ret ? *ret : a_default;
 	}
 
@@ -165,7 +207,7 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return a_default;
 		}
-		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).GetCustomStr(a_stat);
+		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetCustomStr(a_stat);
 		return ret ? *ret : a_default;
 	}
 
@@ -175,7 +217,69 @@ namespace Papyrus::ActorStats
 			a_vm->TraceStack("Actor is none", a_stackID);
 			return;
 		}
-		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor).RemoveCustomStat(a_stat);
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->RemoveCustomStat(a_stat);
+	}
+
+	int GetCustomStatKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_stat)
+	{
+		if (a_stat.empty()) {
+			a_vm->TraceStack("Stat id is empty", a_stackID);
+			return -1;
+		}
+		return static_cast<int>(Registry::Statistics::CustomKeys::GetSingleton()->Intern(a_stat));
+	}
+
+	namespace
+	{
+		bool IsValidKey(VM* a_vm, StackID a_stackID, RE::Actor* a_actor, int a_key)
+		{
+			if (!a_actor) {
+				a_vm->TraceStack("Actor is none", a_stackID);
+				return false;
+			}
+			if (a_key < 0 || static_cast<size_t>(a_key) >= Registry::Statistics::CustomKeys::GetSingleton()->Size()) {
+				a_vm->TraceStack(fmt::format("Invalid stat key {}", a_key).c_str(), a_stackID);
+				return false;
+			}
+			return true;
+		}
+	}
+
+	bool HasCustomStatByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key)
+	{
+		if (!IsValidKey(a_vm, a_stackID, a_actor, a_key))
+			return false;
+		return Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->HasCustom(static_cast<Registry::Statistics::CustomKeys::KeyID>(a_key));
+	}
+
+	void SetCustomStatFltByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, float a_value)
+	{
+		if (!IsValidKey(a_vm, a_stackID, a_actor, a_key))
+			return;
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->SetCustomFlt(static_cast<Registry::Statistics::CustomKeys::KeyID>(a_key), a_value);
+	}
+
+	void SetCustomStatStrByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, RE::BSFixedString a_value)
+	{
+		if (!IsValidKey(a_vm, a_stackID, a_actor, a_key))
+			return;
+		Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor)->SetCustomStr(static_cast<Registry::Statistics::CustomKeys::KeyID>(a_key), a_value);
+	}
+
+	float GetCustomStatFltByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, float a_default)
+	{
+		if (!IsValidKey(a_vm, a_stackID, a_actor, a_key))
+			return a_default;
+		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetCustomFlt(static_cast<Registry::Statistics::CustomKeys::KeyID>(a_key));
+		return ret ? *ret : a_default;
+	}
+
+	RE::BSFixedString GetCustomStatStrByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, RE::BSFixedString a_default)
+	{
+		if (!IsValidKey(a_vm, a_stackID, a_actor, a_key))
+			return a_default;
+		const auto ret = Registry::Statistics::StatisticsData::GetSingleton()->ReadStatistics(a_actor)->GetCustomStr(static_cast<Registry::Statistics::CustomKeys::KeyID>(a_key));
+		return ret ? *ret : a_default;
 	}
 
 	std::vector<RE::Actor*> GetAllEncounters(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor)
@@ -185,7 +289,7 @@ namespace Papyrus::ActorStats
 			return {};
 		}
 		std::vector<RE::Actor*> ret{};
-		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter([&](Registry::Statistics::ActorEncounter& enc) {
+		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter(a_actor, [&](const Registry::Statistics::ActorEncounter& enc) {
 			const auto partner = enc.GetPartner(a_actor);
 			if (!partner)
 				return false;
@@ -205,7 +309,7 @@ namespace Papyrus::ActorStats
 			return {};
 		}
 		std::vector<RE::Actor*> ret{};
-		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter([&](Registry::Statistics::ActorEncounter& enc) {
+		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter(a_actor, [&](const Registry::Statistics::ActorEncounter& enc) {
 			const auto partner = enc.GetPartner(a_actor);
 			if (!partner || enc.GetTimesVictim(partner->id) <= 0)
 				return false;
@@ -223,7 +327,7 @@ namespace Papyrus::ActorStats
 			return {};
 		}
 		std::vector<RE::Actor*> ret{};
-		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter([&](Registry::Statistics::ActorEncounter& enc) {
+		Registry::Statistics::StatisticsData::GetSingleton()->ForEachEncounter(a_actor, [&](const Registry::Statistics::ActorEncounter& enc) {
 			const auto partner = enc.GetPartner(a_actor);
 			if (!partner || enc.GetTimesAssailant(partner->id) <= 0)
 				return false;
@@ -265,6 +369,29 @@ namespace Papyrus::ActorStats
 		return enc->GetLastTimeMet();
 	}
 
+	int GetEncountersInPeriod(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner, int a_encountertype, float a_days)
+	{
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return 0;
+		}
+		const auto type = Registry::Statistics::ActorEncounter::EncounterType(a_encountertype);
+		return static_cast<int>(Registry::Statistics::StatisticsData::GetSingleton()->CountRecentEncounters(a_actor, a_partner, type, a_days));
+	}
+
+	float GetEncounterWeight(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner, int a_encountertype, float a_halflife)
+	{
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return 0.0f;
+		} else if (a_halflife <= 0.0f) {
+			a_vm->TraceStack("Half life must be greater than 0", a_stackID);
+			return 0.0f;
+		}
+		const auto type = Registry::Statistics::ActorEncounter::EncounterType(a_encountertype);
+		return Registry::Statistics::StatisticsData::GetSingleton()->GetEncounterWeight(a_actor, a_partner, type, a_halflife);
+	}
+
 	int GetTimesMet(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner)
 	{
 		if (!a_actor || !a_partner) {
@@ -329,7 +456,7 @@ namespace Papyrus::ActorStats
 	{
 		const auto stats = Registry::Statistics::StatisticsData::GetSingleton();
 		std::vector<RE::BSFixedString> ret{};
-		stats->ForEachStatistic([&](Registry::Statistics::ActorStats& stats) {
+		stats->ForEachStatistic([&](const Registry::Statistics::ActorStats& stats) {
 			const auto keys = stats.GetEveryCustomID();
 			for (auto&& key : keys) {
 				if (key == Purity || key == Lewdness || key == Foreplay)
@@ -350,27 +477,27 @@ namespace Papyrus::ActorStats
 			return 0.0;
 		}
 		const auto statdata = Registry::Statistics::StatisticsData::GetSingleton();
-		const auto& stats = statdata->GetStatistics(a_actor);
+		const auto stats = statdata->ReadStatistics(a_actor);
 		switch (LegacyStatistics(id)) {
 		case LegacyStatistics::L_Foreplay:
 			{
-				auto ret = stats.GetCustomFlt(Foreplay);
+				auto ret = stats->GetCustomFlt(Foreplay);
 				return ret ? *ret : 0;
 			}
 		case LegacyStatistics::XP_Vaginal:
-			return stats.GetStatistic(stats.XP_Vaginal);
+			return stats->GetStatistic(stats->XP_Vaginal);
 		case LegacyStatistics::XP_Anal:
-			return stats.GetStatistic(stats.XP_Anal);
+			return stats->GetStatistic(stats->XP_Anal);
 		case LegacyStatistics::XP_Oral:
-			return stats.GetStatistic(stats.XP_Oral);
+			return stats->GetStatistic(stats->XP_Oral);
 		case LegacyStatistics::L_Pure:
 			{
-				auto ret = stats.GetCustomFlt(Purity);
+				auto ret = stats->GetCustomFlt(Purity);
 				return ret ? *ret : 0;
 			}
 		case LegacyStatistics::L_Lewd:
 			{
-				auto ret = stats.GetCustomFlt(Lewdness);
+				auto ret = stats->GetCustomFlt(Lewdness);
 				return ret ? *ret : 0;
 			}
 		case LegacyStatistics::Times_Males:
@@ -386,20 +513,20 @@ namespace Papyrus::ActorStats
 				return it.race != Registry::RaceKey::Human;
 			}));
 		case LegacyStatistics::Times_Masturbation:
-			return stats.GetStatistic(stats.TimesMasturbated);
+			return stats->GetStatistic(stats->TimesMasturbated);
 		case LegacyStatistics::Times_Aggressor:
-			return stats.GetStatistic(stats.TimesDominant);
+			return stats->GetStatistic(stats->TimesDominant);
 		case LegacyStatistics::Times_Victim:
-			return stats.GetStatistic(stats.TimesSubmissive);
+			return stats->GetStatistic(stats->TimesSubmissive);
 		case LegacyStatistics::SexCount:
-			return stats.GetStatistic(stats.TimesTotal);
+			return stats->GetStatistic(stats->TimesTotal);
 		case LegacyStatistics::PlayerSex:
 			return static_cast<float>(statdata->GetNumberEncounters(a_actor, [](auto& it) {
 				return it.id == 0x14;
 			}));
 		case LegacyStatistics::Sexuality:
 			{
-				auto ret = stats.GetStatistic(stats.Sexuality);
+				auto ret = stats->GetStatistic(stats->Sexuality);
 				constexpr auto rHomo = 35.0f, rBi = 30.0f, rHetero = 35.0f;
 				const auto f = [&](float start, float range, float range_legacy) {
 					float perc = ret / range;
@@ -418,22 +545,22 @@ namespace Papyrus::ActorStats
 				return f(rHomo + rBi, Settings::fPercentageHetero, rHetero);
 			}
 		case LegacyStatistics::TimeSpent:
-			return stats.GetStatistic(stats.SecondsInScene);
+			return stats->GetStatistic(stats->SecondsInScene);
 		case LegacyStatistics::LastSex_RealTime:
 			{
 				constexpr auto seconds_in_day = 86400.0f;
 				const auto timescale = std::max(RE::Calendar::GetSingleton()->GetTimescale(), 1.0f);
-				const auto gametime = stats.GetStatistic(stats.LastUpdate_GameTime);
+				const auto gametime = stats->GetStatistic(stats->LastUpdate_GameTime);
 				return (gametime / timescale) * seconds_in_day;
 			}
 		case LegacyStatistics::LastSex_GameTime:
-			return stats.GetStatistic(stats.LastUpdate_GameTime);
+			return stats->GetStatistic(stats->LastUpdate_GameTime);
 		case LegacyStatistics::Times_VaginalCount:
-			return stats.GetStatistic(stats.TimesVaginal);
+			return stats->GetStatistic(stats->TimesVaginal);
 		case LegacyStatistics::Times_AnalCount:
-			return stats.GetStatistic(stats.TimesAnal);
+			return stats->GetStatistic(stats->TimesAnal);
 		case LegacyStatistics::Times_OralCount:
-			return stats.GetStatistic(stats.TimesOral);
+			return stats->GetStatistic(stats->TimesOral);
 		default:
 			a_vm->TraceStack(fmt::format("Invalid id {}", id).c_str(), a_stackID);
 			return 0.0;
@@ -462,25 +589,25 @@ namespace Papyrus::ActorStats
 			return;
 		}
 		const auto statdata = Registry::Statistics::StatisticsData::GetSingleton();
-		auto& stats = statdata->GetStatistics(a_actor);
+		auto stats = statdata->GetStatistics(a_actor);
 		switch (LegacyStatistics(id)) {
 		case LegacyStatistics::L_Foreplay:
-			stats.SetCustomFlt(Foreplay, a_value);
+			stats->SetCustomFlt(Foreplay, a_value);
 			break;
 		case LegacyStatistics::XP_Vaginal:
-			stats.SetStatistic(stats.XP_Vaginal, a_value);
+			stats->SetStatistic(stats->XP_Vaginal, a_value);
 			break;
 		case LegacyStatistics::XP_Anal:
-			stats.SetStatistic(stats.XP_Anal, a_value);
+			stats->SetStatistic(stats->XP_Anal, a_value);
 			break;
 		case LegacyStatistics::XP_Oral:
-			stats.SetStatistic(stats.XP_Oral, a_value);
+			stats->SetStatistic(stats->XP_Oral, a_value);
 			break;
 		case LegacyStatistics::L_Pure:
-			stats.SetCustomFlt(Purity, a_value);
+			stats->SetCustomFlt(Purity, a_value);
 			break;
 		case LegacyStatistics::L_Lewd:
-			stats.SetCustomFlt(Lewdness, a_value);
+			stats->SetCustomFlt(Lewdness, a_value);
 			break;
 		case LegacyStatistics::Times_Males:
 		case LegacyStatistics::Times_Females:
@@ -488,16 +615,16 @@ namespace Papyrus::ActorStats
 			// Encounter Statistics
 			break;
 		case LegacyStatistics::Times_Masturbation:
-			stats.SetStatistic(stats.TimesMasturbated, a_value);
+			stats->SetStatistic(stats->TimesMasturbated, a_value);
 			break;
 		case LegacyStatistics::Times_Aggressor:
-			stats.SetStatistic(stats.TimesDominant, a_value);
+			stats->SetStatistic(stats->TimesDominant, a_value);
 			break;
 		case LegacyStatistics::Times_Victim:
-			stats.SetStatistic(stats.TimesSubmissive, a_value);
+			stats->SetStatistic(stats->TimesSubmissive, a_value);
 			break;
 		case LegacyStatistics::SexCount:
-			stats.SetStatistic(stats.TimesTotal, a_value);
+			stats->SetStatistic(stats->TimesTotal, a_value);
 			break;
 		case LegacyStatistics::PlayerSex:
 			// Encounter Statistic
@@ -508,7 +635,7 @@ namespace Papyrus::ActorStats
 				auto f = [&](float start, float range, float range_legacy) mutable {
 					float perc = a_value / range_legacy;
 					const auto value = start + perc * range;
-					stats.SetStatistic(stats.Sexuality, value);
+					stats->SetStatistic(stats->Sexuality, value);
 				};
 				if (a_value < rHomo) {
 					f(0, Settings::fPercentageHomo, rHomo);
@@ -526,27 +653,27 @@ namespace Papyrus::ActorStats
 			}
 			break;
 		case LegacyStatistics::TimeSpent:
-			stats.SetStatistic(stats.SecondsInScene, a_value);
+			stats->SetStatistic(stats->SecondsInScene, a_value);
 			break;
 		case LegacyStatistics::LastSex_RealTime:
 			{
 				constexpr auto seconds_in_day = 86400.0f;
 				const auto timescale = std::max(RE::Calendar::GetSingleton()->GetTimescale(), 1.0f);
 				const auto value = (a_value / seconds_in_day) * timescale;
-				stats.SetStatistic(stats.LastUpdate_GameTime, value);
+				stats->SetStatistic(stats->LastUpdate_GameTime, value);
 			}
 			break;
 		case LegacyStatistics::LastSex_GameTime:
-			stats.SetStatistic(stats.LastUpdate_GameTime, a_value);
+			stats->SetStatistic(stats->LastUpdate_GameTime, a_value);
 			break;
 		case LegacyStatistics::Times_VaginalCount:
-			stats.SetStatistic(stats.TimesVaginal, a_value);
+			stats->SetStatistic(stats->TimesVaginal, a_value);
 			break;
 		case LegacyStatistics::Times_AnalCount:
-			stats.SetStatistic(stats.TimesAnal, a_value);
+			stats->SetStatistic(stats->TimesAnal, a_value);
 			break;
 		case LegacyStatistics::Times_OralCount:
-			stats.SetStatistic(stats.TimesOral, a_value);
+			stats->SetStatistic(stats->TimesOral, a_value);
 			break;
 		default:
 			a_vm->TraceStack(fmt::format("Invalid id {}", id).c_str(), a_stackID);
@@ -37,8 +37,13 @@ namespace Papyrus::ActorStats
 
 	std::vector<RE::Actor*> GetAllTrackedActors(RE::StaticFunctionTag*);
 	std::vector<RE::Actor*> GetAllTrackedUniqueActorsSorted(RE::StaticFunctionTag*);
+	std::vector<RE::Actor*> GetTrackedUniqueActorsPage(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, int a_page, int a_pagesize);
+	int GetTrackedUniqueActorCount(RE::StaticFunctionTag*);
 	void SetStatistic(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int id, float a_value);
 	float GetStatistic(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int id);
+	std::vector<float> GetAllStatistics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
+	std::vector<float> GetStatisticsMatrix(RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors);
+	void AddStatistics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors, std::vector<int> a_ids, std::vector<float> a_values);
 	int GetSexuality(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
 	void SetSexuality(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int mapping);
 	int MapSexuality(RE::StaticFunctionTag*, float a_sexuality);
@@ -51,12 +56,22 @@ namespace Papyrus::ActorStats
 	RE::BSFixedString GetCustomStatStr(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat, RE::BSFixedString a_default);
 	void DeleteCustomStat(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_stat);
 
+	// Custom stats addressed through a handle, valid until the game is closed
+	int GetCustomStatKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_stat);
+	bool HasCustomStatByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key);
+	void SetCustomStatFltByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, float a_value);
+	void SetCustomStatStrByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, RE::BSFixedString a_value);
+	float GetCustomStatFltByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, float a_default);
+	RE::BSFixedString GetCustomStatStrByKey(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_key, RE::BSFixedString a_default);
+
 	std::vector<RE::Actor*> GetAllEncounters(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
 	std::vector<RE::Actor*> GetAllEncounteredVictims(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
 	std::vector<RE::Actor*> GetAllEncounteredAssailants(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
 	RE::Actor* GetMostRecentEncounter(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, int a_encountertype);
 	void AddEncounter(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner, int a_encountertype);
 	float GetLastEncounterTime(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner);
+	int GetEncountersInPeriod(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner, int a_encountertype, float a_days);
+	float GetEncounterWeight(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner, int a_encountertype, float a_halflife);
 	int GetTimesMet(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_partner);
 	int GetTimesVictimzed(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_assailant);
 	int GetTimesAssaulted(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::Actor* a_victim);
@@ -74,8 +89,13 @@ namespace Papyrus::ActorStats
 	{
 		REGISTERFUNC(GetAllTrackedActors, "SexLabStatistics", true);
 		REGISTERFUNC(GetAllTrackedUniqueActorsSorted, "SexLabStatistics", true);
+		REGISTERFUNC(GetTrackedUniqueActorsPage, "SexLabStatistics", true);
+		REGISTERFUNC(GetTrackedUniqueActorCount, "SexLabStatistics", true);
 		REGISTERFUNC(SetStatistic, "SexLabStatistics", true);
 		REGISTERFUNC(GetStatistic, "SexLabStatistics", true);
+		REGISTERFUNC(GetAllStatistics, "SexLabStatistics", true);
+		REGISTERFUNC(GetStatisticsMatrix, "SexLabStatistics", true);
+		REGISTERFUNC(AddStatistics, "SexLabStatistics", true);
 
 		REGISTERFUNC(GetAllCustomStatIDs, "SexLabStatistics", true);
 		REGISTERFUNC(HasCustomStat, "SexLabStatistics", true);
@@ -84,6 +104,12 @@ namespace Papyrus::ActorStats
 		REGISTERFUNC(GetCustomStatFlt, "SexLabStatistics", true);
 		REGISTERFUNC(GetCustomStatStr, "SexLabStatistics", true);
 		REGISTERFUNC(DeleteCustomStat, "SexLabStatistics", true);
+		REGISTERFUNC(GetCustomStatKey, "SexLabStatistics", true);
+		REGISTERFUNC(HasCustomStatByKey, "SexLabStatistics", true);
+		REGISTERFUNC(SetCustomStatFltByKey, "SexLabStatistics", true);
+		REGISTERFUNC(SetCustomStatStrByKey, "SexLabStatistics", true);
+		REGISTERFUNC(GetCustomStatFltByKey, "SexLabStatistics", true);
+		REGISTERFUNC(GetCustomStatStrByKey, "SexLabStatistics", true);
 
 		REGISTERFUNC(GetAllEncounters, "SexLabStatistics", true);
 		REGISTERFUNC(GetAllEncounteredVictims, "SexLabStatistics", true);
@@ -91,6 +117,8 @@ namespace Papyrus::ActorStats
 		REGISTERFUNC(GetMostRecentEncounter, "SexLabStatistics", true);
 		REGISTERFUNC(AddEncounter, "SexLabStatistics", true);
 		REGISTERFUNC(GetLastEncounterTime, "SexLabStatistics", true);
+		REGISTERFUNC(GetEncountersInPeriod, "SexLabStatistics", true);
+		REGISTERFUNC(GetEncounterWeight, "SexLabStatistics", true);
 		REGISTERFUNC(GetTimesMet, "SexLabStatistics", true);
 		REGISTERFUNC(GetTimesVictimzed, "SexLabStatistics", true);
 		REGISTERFUNC(GetTimesAssaulted, "SexLabStatistics", true);
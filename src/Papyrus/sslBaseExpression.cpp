@@ -141,6 +141,52 @@ namespace Papyrus::BaseExpression
 			data.emplace_back();
 		}
 		std::copy_n(a_values.begin(), data[a_level].size(), data[a_level].begin());
+		profile->Compile();
+	}
+
+	std::vector<float> GetBlendedValues(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_id, bool a_female, float a_intensity)
+	{
+		const auto profile = Registry::Expression::GetSingleton()->GetProfile(a_id);
+		if (!profile) {
+			a_vm->TraceStack("Invalid Expression Profile ID", a_stackID);
+			return std::vector<float>(Registry::Expression::Profile::Total);
+		}
+		const auto ret = profile->Evaluate(a_female ? RE::SEXES::kFemale : RE::SEXES::kMale, a_intensity);
+		return { ret.begin(), ret.end() };
+	}
+
+	bool RegisterExpression(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_id, float a_intensity)
+	{
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return false;
+		}
+		if (!Registry::Expression::GetSingleton()->GetProfile(a_id)) {
+			a_vm->TraceStack("Invalid Expression Profile ID", a_stackID);
+			return false;
+		}
+		Registry::ExpressionScheduler::GetSingleton()->Register(a_actor, a_id, std::clamp(a_intensity, 0.0f, 1.0f));
+		return true;
+	}
+
+	void SetExpressionIntensity(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, float a_intensity)
+	{
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return;
+		}
+		if (!Registry::ExpressionScheduler::GetSingleton()->SetIntensity(a_actor, std::clamp(a_intensity, 0.0f, 1.0f))) {
+			a_vm->TraceStack(fmt::format("Actor {:X} has no registered expression", a_actor->GetFormID()).c_str(), a_stackID);
+		}
+	}
+
+	void UnregisterExpression(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor)
+	{
+		if (!a_actor) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return;
+		}
+		Registry::ExpressionScheduler::GetSingleton()->Unregister(a_actor);
 	}
 
 } // namespace Papyrus::BaseExpression
@@ -14,6 +14,11 @@ namespace Papyrus::BaseExpression
 	std::vector<int32_t> GetLevelCounts(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_id);
 	std::vector<float> GetValues(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_id, bool a_female, int a_level);
 	void SetValues(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_id, bool a_female, int a_level, std::vector<float> a_values);
+	std::vector<float> GetBlendedValues(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::BSFixedString a_id, bool a_female, float a_intensity);
+
+	bool RegisterExpression(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_id, float a_intensity);
+	void SetExpressionIntensity(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor, float a_intensity);
+	void UnregisterExpression(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::Actor* a_actor);
 
 	inline bool Register(VM* a_vm)
 	{
@@ -28,6 +33,10 @@ namespace Papyrus::BaseExpression
 		REGISTERFUNC(GetLevelCounts, "sslBaseExpression", true);
 		REGISTERFUNC(GetValues, "sslBaseExpression", true);
 		REGISTERFUNC(SetValues, "sslBaseExpression", true);
+		REGISTERFUNC(GetBlendedValues, "sslBaseExpression", true);
+		REGISTERFUNC(RegisterExpression, "sslBaseExpression", true);
+		REGISTERFUNC(SetExpressionIntensity, "sslBaseExpression", true);
+		REGISTERFUNC(UnregisterExpression, "sslBaseExpression", true);
 
 		return true;
 	}
@@ -1,6 +1,7 @@
 #include "sslSystemConfig.h"
 
 #include "Registry/Library.h"
+#include "Registry/Physics.h"
 #include "UserData/StripData.h"
 
 namespace Papyrus::SystemConfig
@@ -74,6 +75,7 @@ namespace Papyrus::SystemConfig
 			return;
 
 		*s = a_value;
+		Settings::generation++;
 	}
 
 	void SetSettingFlt(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, float a_value)
@@ -83,6 +85,7 @@ namespace Papyrus::SystemConfig
 			return;
 
 		*s = a_value;
+		Settings::generation++;
 	}
 
 	void SetSettingBool(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, bool a_value)
@@ -92,6 +95,7 @@ namespace Papyrus::SystemConfig
 			return;
 
 		*s = a_value;
+		Settings::generation++;
 	}
 
 	void SetSettingStr(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, std::string a_value)
@@ -101,6 +105,7 @@ namespace Papyrus::SystemConfig
 			return;
 
 		*s = a_value;
+		Settings::generation++;
 	}
 
 	void SetSettingIntA(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, int a_value, int n)
@@ -114,6 +119,7 @@ namespace Papyrus::SystemConfig
 		}
 
 		(*s)[n] = a_value;
+		Settings::generation++;
   }
 
 	void SetSettingFltA(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, float a_value, int n)
@@ -127,6 +133,16 @@ namespace Papyrus::SystemConfig
 		}
 
 		(*s)[n] = a_value;
+		Settings::generation++;
+	}
+
+	int ReplayPhysics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_file, bool a_makegolden)
+	{
+		if (a_file.empty()) {
+			a_vm->TraceStack("Missing record file", a_stackID);
+			return -1;
+		}
+		return Registry::Physics::Replay(a_file, a_makegolden);
 	}
 
 	int GetAnimationCount(RE::StaticFunctionTag*)
@@ -19,6 +19,8 @@ namespace Papyrus::SystemConfig
 	void SetSettingIntA(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, int a_value, int n);
 	void SetSettingFltA(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_setting, float a_value, int n);
 
+	int ReplayPhysics(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, std::string a_file, bool a_makegolden);
+
 	inline bool Register(VM* a_vm)
 	{
 		REGISTERFUNC(GetAnimationCount, "sslSystemConfig", true);
@@ -38,6 +40,8 @@ namespace Papyrus::SystemConfig
 		REGISTERFUNC(SetSettingIntA, "sslSystemConfig", true);
 		REGISTERFUNC(SetSettingFltA, "sslSystemConfig", true);
 
+		REGISTERFUNC(ReplayPhysics, "sslSystemConfig", false);
+
 		return true;
 	}
 
@@ -6,6 +6,8 @@
 #include "Registry/Define/Furniture.h"
 #include "Registry/Define/RaceKey.h"
 #include "Registry/Library.h"
+#include "Registry/Stats.h"
+#include "Registry/Util/Nearest.h"
 #include "Registry/Validation.h"
 
 namespace Papyrus::ThreadLibrary
@@ -22,6 +24,21 @@ namespace Papyrus::ThreadLibrary
 		return Registry::BedHandler::GetBedsInArea(a_center, a_radius, a_radiusZ);
 	}
 
+	RE::TESObjectREFR* PickBed(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_center, float a_radius, float a_radiusZ, int32_t a_candidates)
+	{
+		if (!a_center) {
+			a_vm->TraceStack("Cannot find refs from a none center", a_stackID);
+			return nullptr;
+		} else if (a_radius < 0.0f) {
+			a_vm->TraceStack("Cannot find refs within a negative radius", a_stackID);
+			return nullptr;
+		} else if (a_candidates < 1) {
+			a_vm->TraceStack("Number of candidates must be at least 1", a_stackID);
+			return nullptr;
+		}
+		return Registry::BedHandler::PickBedInArea(a_center, a_radius, a_radiusZ, a_candidates);
+	}
+
 	int32_t GetBedTypeImpl(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_reference)
 	{
 		if (!a_reference) {
@@ -40,51 +57,80 @@ namespace Papyrus::ThreadLibrary
 		return Registry::BedHandler::IsBed(a_reference);
 	}
 
-	std::vector<RE::Actor*> FindAvailableActors(VM* a_vm, StackID a_stackID, RE::TESQuest*, RE::TESObjectREFR* a_center, float a_radius, LegacySex a_targetsex,
-		RE::Actor* ignore_ref01, RE::Actor* ignore_ref02, RE::Actor* ignore_ref03, RE::Actor* ignore_ref04, RE::BSFixedString a_targetrace)
+	namespace
 	{
-		if (!a_center) {
-			a_vm->TraceStack("Cannot find actor from a none reference", a_stackID);
-			return {};
-		} else if (a_targetsex < LegacySex::None || a_targetsex > LegacySex::CrtFemale) {
-			a_vm->TraceStack(fmt::format("Invalid target sex. Argument should be in [{}; {}]", LegacySex::None, LegacySex::CrtFemale).c_str(), a_stackID);
-			return {};
-		} else if (a_radius < 0) {
-			a_vm->TraceStack("Cannot find actor in negative radius", a_stackID);
-			return {};
-		}
-		const auto targetsex = [&]() {
-			if (a_targetsex >= LegacySex::CrtMale || !a_targetrace.empty() && a_targetrace != "humans") {
-				if (a_targetsex == LegacySex::Male || !Settings::bCreatureGender) {
-					return LegacySex::CrtMale;
-				} else if (a_targetsex == LegacySex::Female) {
-					return LegacySex::CrtFemale;
-				}
-			}
-			return a_targetsex;
-		}();
-		const auto targetrace = Registry::RaceHandler::GetRaceKey(a_targetrace.empty() ? "humans" : a_targetrace);
-		std::vector<RE::Actor*> ret{};
-		const auto& highactors = RE::ProcessLists::GetSingleton()->highActorHandles;
-		for (auto&& handle : highactors) {
-			const auto& actor = handle.get();
-			if (!actor ||
-					actor.get() == ignore_ref01 ||
-					actor.get() == ignore_ref02 ||
-					actor.get() == ignore_ref03 ||
-					actor.get() == ignore_ref04)
-				continue;
+		constexpr float SAME_FLOOR_DISTANCE = 200.0f;
 
-			if (!Registry::RaceHandler::HasRaceKey(actor.get(), targetrace))
-				continue;
-			if (targetsex != LegacySex::None && GetLegacySex(actor.get()) != targetsex)
-				continue;
-			if (!Registry::IsValidActor(actor.get()))
-				continue;
+		/// Valid actors around a_center matching all given filters, closest first
+		/// @param a_radius, a_radiusz 0 to not limit the distance (along the z axis)
+		std::vector<RE::Actor*> SearchActors(VM* a_vm, StackID a_stackID, RE::TESObjectREFR* a_center, float a_radius, float a_radiusz, LegacySex a_targetsex,
+			std::array<RE::Actor*, 4> a_ignore, RE::BSFixedString a_targetrace)
+		{
+			if (!a_center) {
+				a_vm->TraceStack("Cannot find actor from a none reference", a_stackID);
+				return {};
+			} else if (a_targetsex < LegacySex::None || a_targetsex > LegacySex::CrtFemale) {
+				a_vm->TraceStack(fmt::format("Invalid target sex. Argument should be in [{}; {}]", LegacySex::None, LegacySex::CrtFemale).c_str(), a_stackID);
+				return {};
+			} else if (a_radius < 0) {
+				a_vm->TraceStack("Cannot find actor in negative radius", a_stackID);
+				return {};
+			}
+			const auto targetsex = [&]() {
+				if (a_targetsex >= LegacySex::CrtMale || !a_targetrace.empty() && a_targetrace != "humans") {
+					if (a_targetsex == LegacySex::Male || !Settings::bCreatureGender) {
+						return LegacySex::CrtMale;
+					} else if (a_targetsex == LegacySex::Female) {
+						return LegacySex::CrtFemale;
+					}
+				}
+				return a_targetsex;
+			}();
+			const auto targetrace = Registry::RaceHandler::GetRaceKey(a_targetrace.empty() ? "humans" : a_targetrace);
+			const auto center = a_center->GetPosition();
+			const auto radius2 = a_radius * a_radius;
+			size_t inrange = 0, validations = 0;
+			std::vector<Nearest::Keyed<RE::Actor*>> candidates{};
+			const auto& highactors = RE::ProcessLists::GetSingleton()->highActorHandles;
+			for (auto&& handle : highactors) {
+				const auto& actor = handle.get();
+				if (!actor || std::ranges::find(a_ignore, actor.get()) != a_ignore.end())
+					continue;
+				// Cheapest checks first, full validation only for actors passing every other filter
+				const auto position = actor->GetPosition();
+				const auto distance2 = center.GetSquaredDistance(position);
+				if (a_radius > 0.0f && distance2 > radius2)
+					continue;
+				if (a_radiusz > 0.0f && std::fabs(center.z - position.z) > a_radiusz)
+					continue;
+				inrange++;
+				if (!Registry::RaceHandler::HasRaceKey(actor.get(), targetrace))
+					continue;
+				if (targetsex != LegacySex::None && GetLegacySex(actor.get()) != targetsex)
+					continue;
+				bool recomputed = false;
+				const auto valid = Registry::IsValidActorCached(actor.get(), recomputed) > 0;
+				validations += recomputed;
+				if (!valid)
+					continue;
 
-			ret.push_back(actor.get());
+				candidates.emplace_back(std::sqrt(distance2), actor.get());
+			}
+			Nearest::SelectClosest(candidates, candidates.size());
+			logger::debug("Actor search found {}/{} actors in range, {} full validations", candidates.size(), inrange, validations);
+			std::vector<RE::Actor*> ret{};
+			ret.reserve(candidates.size());
+			for (auto&& [_, actor] : candidates) {
+				ret.push_back(actor);
+			}
+			return ret;
 		}
-		return ret;
+	}
+
+	std::vector<RE::Actor*> FindAvailableActors(VM* a_vm, StackID a_stackID, RE::TESQuest*, RE::TESObjectREFR* a_center, float a_radius, LegacySex a_targetsex,
+		RE::Actor* ignore_ref01, RE::Actor* ignore_ref02, RE::Actor* ignore_ref03, RE::Actor* ignore_ref04, RE::BSFixedString a_targetrace)
+	{
+		return SearchActors(a_vm, a_stackID, a_center, a_radius, 0.0f, a_targetsex, { ignore_ref01, ignore_ref02, ignore_ref03, ignore_ref04 }, a_targetrace);
 	}
 
 	RE::Actor* FindAvailableActor(VM* a_vm, StackID a_stackID, RE::TESQuest*, RE::TESObjectREFR* a_center, float a_radius, LegacySex a_targetsex,
@@ -101,10 +147,9 @@ namespace Papyrus::ThreadLibrary
 			a_vm->TraceStack("Cannot find actor in none faction", a_stackID);
 			return nullptr;
 		}
-		auto valids = FindAvailableActors(a_vm, a_stackID, nullptr, a_center, a_radius, a_targetsex, ignore_ref01, ignore_ref02, ignore_ref03, ignore_ref04, a_targetrace);
+		const auto valids = SearchActors(a_vm, a_stackID, a_center, a_radius, a_samefloor ? SAME_FLOOR_DISTANCE : 0.0f, a_targetsex,
+			{ ignore_ref01, ignore_ref02, ignore_ref03, ignore_ref04 }, a_targetrace);
 		for (auto&& actor : valids) {
-			if (a_samefloor && std::fabs(a_center->GetPositionZ() - actor->GetPositionZ()) > 200)
-				continue;
 			if (actor->IsInFaction(a_faction) != a_hasfaction)
 				continue;
 
@@ -122,10 +167,9 @@ namespace Papyrus::ThreadLibrary
 			return nullptr;
 		}
 		const auto slotmask = RE::BGSBipedObjectForm::BipedObjectSlot(a_slotmask);
-		const auto valids = FindAvailableActors(a_vm, a_stackID, nullptr, a_center, a_radius, a_targetsex, ignore_ref01, ignore_ref02, ignore_ref03, ignore_ref04, a_targetrace);
+		const auto valids = SearchActors(a_vm, a_stackID, a_center, a_radius, a_samefloor ? SAME_FLOOR_DISTANCE : 0.0f, a_targetsex,
+			{ ignore_ref01, ignore_ref02, ignore_ref03, ignore_ref04 }, a_targetrace);
 		for (auto&& actor : valids) {
-			if (a_samefloor && std::fabs(a_center->GetPositionZ() - actor->GetPositionZ()) > 200)
-				continue;
 			const auto armo = actor->GetWornArmor(slotmask);
 			if (static_cast<bool>(armo) != a_shouldwear)
 				continue;
@@ -227,6 +271,96 @@ namespace Papyrus::ThreadLibrary
 		return ret;
 	}
 
+	std::vector<RE::Actor*> FindScoredPartners(VM* a_vm, StackID a_stackID, RE::TESQuest*,
+		RE::Actor* a_seeker, std::vector<RE::Actor*> a_group, float a_radius, int32_t a_count)
+	{
+		using Stats = Registry::Statistics::ActorStats;
+		// Relative importance of each part of a candidate's score, every part is in [0; 1]
+		constexpr float WEIGHT_ATTRACTION = 4.0f;
+		constexpr float WEIGHT_FAMILIARITY = 2.0f;
+		constexpr float WEIGHT_AROUSAL = 1.0f;
+		constexpr float WEIGHT_DISTANCE = 1.0f;
+		constexpr float ENCOUNTER_HALFLIFE = 30.0f;	 // game days
+		constexpr float UNKNOWN_SEXUALITY = 50.0f;	 // for actors without statistics, scoring does not start tracking them
+
+		if (!a_seeker) {
+			a_vm->TraceStack("Cannot find partners for a none actor", a_stackID);
+			return {};
+		} else if (a_count < 1) {
+			a_vm->TraceStack("Number of partners must be at least 1", a_stackID);
+			return {};
+		} else if (std::ranges::find(a_group, nullptr) != a_group.end()) {
+			a_vm->TraceStack("Group contains none", a_stackID);
+			return {};
+		}
+		std::erase(a_group, a_seeker);
+		a_group.insert(a_group.begin(), a_seeker);
+		if (a_group.size() >= Registry::MAX_ACTOR_COUNT) {
+			a_vm->TraceStack(fmt::format("Group already holds the maximum of {} actors", Registry::MAX_ACTOR_COUNT).c_str(), a_stackID);
+			return {};
+		}
+		auto candidates = SearchActors(a_vm, a_stackID, a_seeker, a_radius, 0.0f, LegacySex::None, {}, "");
+		std::erase_if(candidates, [&](RE::Actor* it) { return std::ranges::find(a_group, it) != a_group.end(); });
+		if (candidates.empty()) {
+			return {};
+		}
+
+		const auto library = Registry::Library::GetSingleton();
+		std::vector<Registry::PositionFragment> fragments{};
+		fragments.reserve(a_group.size() + 1);
+		for (auto&& member : a_group) {
+			fragments.push_back(Registry::MakeFragmentFromActor(member, false));
+		}
+		// Seeker in the first row, followed by each candidate
+		std::vector<RE::Actor*> rows{ a_seeker };
+		rows.insert(rows.end(), candidates.begin(), candidates.end());
+		const auto statistics = Registry::Statistics::StatisticsData::GetSingleton();
+		std::vector<bool> tracked{};
+		const auto matrix = statistics->FindStatisticMatrix(rows, &tracked);
+		const auto getStat = [&](size_t a_row, Stats::StatisticID a_stat) { return matrix[a_row * Stats::Total + a_stat]; };
+		const auto getSexuality = [&](size_t a_row) { return tracked[a_row] ? getStat(a_row, Stats::Sexuality) : UNKNOWN_SEXUALITY; };
+		const auto isFemale = [](RE::Actor* a_actor) {
+			const auto sex = Registry::GetSex(a_actor);
+			return sex == Registry::Sex::Female || sex == Registry::Sex::Futa;
+		};
+		// Sexuality ranges from 0 (homosexual) to 100 (heterosexual)
+		const auto attraction = [](float a_sexuality, bool a_samesex) { return (a_samesex ? 100.0f - a_sexuality : a_sexuality) / 100.0f; };
+
+		const auto seekerFemale = isFemale(a_seeker);
+		const auto seekerPosition = a_seeker->GetPosition();
+		const auto radius = a_radius > 0.0f ? a_radius : std::max(seekerPosition.GetDistance(candidates.back()->GetPosition()), 1.0f);
+		size_t rejected = 0;
+		std::vector<std::pair<float, RE::Actor*>> scores{};
+		for (size_t i = 0; i < candidates.size(); i++) {
+			const auto candidate = candidates[i];
+			fragments.push_back(Registry::MakeFragmentFromActor(candidate, false));
+			const auto available = library->HasScenes(fragments);
+			fragments.pop_back();
+			if (!available) {
+				rejected++;
+				continue;
+			}
+			const auto row = i + 1;
+			const auto samesex = isFemale(candidate) == seekerFemale;
+			const auto mutual = attraction(getSexuality(0), samesex) * attraction(getSexuality(row), samesex);
+			const auto encounters = statistics->GetEncounterWeight(a_seeker, candidate, Registry::Statistics::ActorEncounter::EncounterType::Any, ENCOUNTER_HALFLIFE);
+			const auto familiarity = encounters / (1.0f + encounters);
+			const auto arousal = std::clamp(getStat(row, Stats::Arousal) / 100.0f, 0.0f, 1.0f);
+			const auto proximity = 1.0f - std::clamp(seekerPosition.GetDistance(candidate->GetPosition()) / radius, 0.0f, 1.0f);
+			const auto score = WEIGHT_ATTRACTION * mutual + WEIGHT_FAMILIARITY * familiarity + WEIGHT_AROUSAL * arousal + WEIGHT_DISTANCE * proximity;
+			scores.emplace_back(score, candidate);
+		}
+		const auto count = std::min<size_t>(a_count, scores.size());
+		std::partial_sort(scores.begin(), scores.begin() + count, scores.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		logger::debug("Scored {} partners for {:X}, {} rejected for lack of scenes", scores.size(), a_seeker->GetFormID(), rejected);
+		std::vector<RE::Actor*> ret{};
+		ret.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			ret.push_back(scores[i].second);
+		}
+		return ret;
+	}
+
 	std::vector<RE::Actor*> SortActorsByAnimationImpl(VM* a_vm, StackID a_stackID, RE::TESQuest*,
 		RE::BSFixedString a_sceneid, std::vector<RE::Actor*> a_positions, std::vector<RE::Actor*> a_submissives)
 	{
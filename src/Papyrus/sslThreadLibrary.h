@@ -5,6 +5,7 @@
 namespace Papyrus::ThreadLibrary
 {
 	std::vector<RE::TESObjectREFR*> FindBeds(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_center, float a_radius, float a_radiusz);
+	RE::TESObjectREFR* PickBed(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_center, float a_radius, float a_radiusz, int32_t a_candidates);
 	int32_t GetBedTypeImpl(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_reference);
 	bool IsBed(VM* a_vm, StackID a_stackID, RE::StaticFunctionTag*, RE::TESObjectREFR* a_reference);
 
@@ -22,6 +23,8 @@ namespace Papyrus::ThreadLibrary
 		std::vector<RE::Actor*> a_positions, int a_total, int a_males, int a_females, float a_radius);
 	std::vector<RE::Actor*> FindAnimationPartnersImpl(VM* a_vm, StackID a_stackID, RE::TESQuest*,
 		RE::BSFixedString a_sceneid, RE::TESObjectREFR* a_center, float a_radius, std::vector<RE::Actor*> a_includes);
+	std::vector<RE::Actor*> FindScoredPartners(VM* a_vm, StackID a_stackID, RE::TESQuest*,
+		RE::Actor* a_seeker, std::vector<RE::Actor*> a_group, float a_radius, int32_t a_count);
 
 	std::vector<RE::Actor*> SortActorsByAnimationImpl(VM* a_vm, StackID a_stackID, RE::TESQuest*,
 		RE::BSFixedString a_sceneid, std::vector<RE::Actor*> a_positions, std::vector<RE::Actor*> a_submissives);
@@ -34,6 +37,7 @@ namespace Papyrus::ThreadLibrary
 	inline bool Register(VM* a_vm)
 	{
 		REGISTERFUNC(FindBeds, "sslThreadLibrary", false);
+		REGISTERFUNC(PickBed, "sslThreadLibrary", false);
 		REGISTERFUNC(GetBedTypeImpl, "sslThreadLibrary", false);
 		REGISTERFUNC(IsBed, "sslThreadLibrary", false);
 
@@ -44,6 +48,7 @@ namespace Papyrus::ThreadLibrary
 
 		REGISTERFUNC(FindAvailablePartners, "sslThreadLibrary", false);
 		REGISTERFUNC(FindAnimationPartnersImpl, "sslThreadLibrary", false);
+		REGISTERFUNC(FindScoredPartners, "sslThreadLibrary", false);
 
 		REGISTERFUNC(SortActorsByAnimationImpl, "sslThreadLibrary", true);
 
@@ -3,9 +3,9 @@
 #include "Registry/Animation.h"
 #include "Registry/Define/Furniture.h"
 #include "Registry/Library.h"
+#include "Registry/Util/Nearest.h"
 #include "Registry/Physics.h"
 #include "Registry/Stats.h"
-#include "Registry/Util/CellCrawler.h"
 #include "Registry/Util/Scale.h"
 
 using Offset = Registry::CoordinateType;
@@ -152,32 +152,25 @@ namespace Papyrus::ThreadModel
 			used_furnitures.push_back(furni.get());
 		}
 
-		std::vector<std::pair<RE::TESObjectREFR*, const Registry::FurnitureDetails*>> found_objects;
-		CellCrawler::ForEachObjectInRange(actor, Settings::fScanRadius, [&](RE::TESObjectREFR* a_ref) {
-			if (!a_ref || std::ranges::find(used_furnitures, a_ref) != used_furnitures.end()) {
-				return RE::BSContainer::ForEachResult::kContinue;
-			}
-			const auto details = library->GetFurnitureDetails(a_ref);
-			if (!details || !details->HasType(scene_map, [](auto& it) { return it.first; })) {
-				return RE::BSContainer::ForEachResult::kContinue;
-			}
-			found_objects.push_back(std::make_pair(a_ref, details));
-			return RE::BSContainer::ForEachResult::kContinue;
-		});
-		std::vector<std::tuple<Registry::FurnitureType, Registry::Coordinate, RE::TESObjectREFR*>> coords{};
+		stl::enumeration<Registry::FurnitureType> scene_types{};
+		for (auto&& [type, _] : scene_map) {
+			scene_types.set(type);
+		}
+		auto found_objects = Registry::FurnitureIndex::GetSingleton()->Query(actor->GetPosition(), Settings::fScanRadius, scene_types);
+		std::erase_if(found_objects, [&](const auto& it) { return std::ranges::find(used_furnitures, it.first) != used_furnitures.end(); });
+		using Candidate = std::tuple<Registry::FurnitureType, Registry::Coordinate, RE::TESObjectREFR*>;
+		std::vector<Nearest::Keyed<Candidate>> coords{};
 		for (auto&& [ref, details] : found_objects) {
 			const auto res = details->GetClosestCoordinateInBound(ref, filled_types, actor);
 			for (auto&& pair : res) {
-				coords.push_back(std::make_tuple(pair.first, pair.second, ref));
+				coords.emplace_back(pair.second.GetDistance(actor), std::make_tuple(pair.first, pair.second, ref));
 			}
 		}
-		if (!coords.empty()) {
-			std::sort(coords.begin(), coords.end(), [&](auto& a, auto& b) {
-				return std::get<1>(a).GetDistance(actor) < std::get<1>(b).GetDistance(actor);
-			});
-			const auto& res = coords[0];
-			if (ReturnData(std::get<0>(res), std::get<1>(res))) {
-				return std::get<2>(res);
+		const auto count = Nearest::SelectClosest(coords, std::max<size_t>(Settings::iFurnitureCandidates, 1));
+		if (count > 0) {
+			const auto& [type, coordinate, ref] = count == 1 ? coords.front().second : Nearest::PickWeighted(std::span<const Nearest::Keyed<Candidate>>{ coords.data(), count });
+			if (ReturnData(type, coordinate)) {
+				return ref;
 			}
 		}
 		Registry::Coordinate coord{ actor };
@@ -489,6 +482,66 @@ namespace Papyrus::ThreadModel
 		return 0.0f;
 	}
 
+	float GetPhysicAcceleration(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, RE::Actor* a_partner, int a_type)
+	{
+		if (!a_position || !a_partner) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return 0.0f;
+		} else if (a_type == -1) {
+			a_vm->TraceStack("Type cant be 'any' here", a_stackID);
+			return 0.0f;
+		}
+		auto data = Registry::Physics::GetSingleton()->GetData(a_qst->formID);
+		if (!data) {
+			a_vm->TraceStack("Not registered", a_stackID);
+			return 0.0f;
+		}
+		for (auto&& p : data->_positions) {
+			if (p._owner != a_position->formID)
+				continue;
+			for (auto&& type : p._types) {
+				if (a_partner->formID != type._partner)
+					continue;
+				if (a_type != static_cast<int>(type._type))
+					continue;
+				return type._acceleration;
+			}
+		}
+		return 0.0f;
+	}
+
+	float GetPhysicTypeFraction(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, RE::Actor* a_partner, int a_type, float a_seconds)
+	{
+		if (!a_position || !a_partner) {
+			a_vm->TraceStack("Actor is none", a_stackID);
+			return 0.0f;
+		} else if (a_type == -1) {
+			a_vm->TraceStack("Type cant be 'any' here", a_stackID);
+			return 0.0f;
+		}
+		auto data = Registry::Physics::GetSingleton()->GetData(a_qst->formID);
+		if (!data) {
+			a_vm->TraceStack("Not registered", a_stackID);
+			return 0.0f;
+		}
+		const auto ret = data->GetActiveFraction(a_position->formID, a_partner->formID, a_type, a_seconds * 1000.0f);
+		if (ret < 0.0f) {
+			a_vm->TraceStack("Actor or type not part of this scene", a_stackID);
+			return 0.0f;
+		}
+		return ret;
+	}
+
+	float GetPhysicTickRate(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst)
+	{
+		auto data = Registry::Physics::GetSingleton()->GetData(a_qst->formID);
+		if (!data) {
+			a_vm->TraceStack("Not registered", a_stackID);
+			return 0.0f;
+		}
+		return data->GetTickRate();
+	}
+
 	void AddExperience(VM* a_vm, StackID a_stackID, RE::TESQuest*, std::vector<RE::Actor*> a_positions,
 		RE::BSFixedString a_scene, std::vector<RE::BSFixedString> a_playedstages)
 	{
@@ -510,16 +563,17 @@ namespace Papyrus::ThreadModel
 			anal += stage->tags.HasTag(Registry::Tag::Anal);
 			oral += stage->tags.HasTag(Registry::Tag::Oral);
 		}
-		const auto statdata = Registry::Statistics::StatisticsData::GetSingleton();
+		using Stats = Registry::Statistics::ActorStats;
+		std::vector<Registry::Statistics::StatisticDelta> deltas{};
 		for (auto&& p : a_positions) {
 			if (!p)
 				continue;
 
-			auto& stats = statdata->GetStatistics(p);
-			stats.AddStatistic(stats.XP_Vaginal, vaginal * 1.25f);
-			stats.AddStatistic(stats.XP_Anal, anal * 1.25f);
-			stats.AddStatistic(stats.XP_Oral, oral * 1.25f);
+			deltas.emplace_back(p, Stats::XP_Vaginal, vaginal * 1.25f);
+			deltas.emplace_back(p, Stats::XP_Anal, anal * 1.25f);
+			deltas.emplace_back(p, Stats::XP_Oral, oral * 1.25f);
 		}
+		Registry::Statistics::StatisticsData::GetSingleton()->AddStatistics(deltas);
 	}
 
 
@@ -538,14 +592,14 @@ namespace Papyrus::ThreadModel
 			a_vm->TraceStack("Position cound does not match scene position count", a_stackID);
 			return;
 		}
-		auto& stats = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor);
-		stats.SetStatistic(stats.LastUpdate_GameTime, RE::Calendar::GetSingleton()->GetCurrentGameTime());
-		stats.AddStatistic(stats.SecondsInScene, a_time);
-		stats.AddStatistic(stats.TimesTotal, 1);
+		auto stats = Registry::Statistics::StatisticsData::GetSingleton()->GetStatistics(a_actor);
+		stats->SetStatistic(stats->LastUpdate_GameTime, RE::Calendar::GetSingleton()->GetCurrentGameTime());
+		stats->AddStatistic(stats->SecondsInScene, a_time);
+		stats->AddStatistic(stats->TimesTotal, 1);
 		if (scene->CountPositions() == 1) {
-			stats.AddStatistic(stats.TimesMasturbated, 1);
+			stats->AddStatistic(stats->TimesMasturbated, 1);
 			if (scene->CountSubmissives() == 1) {
-				stats.AddStatistic(stats.TimesSubmissive, 1);
+				stats->AddStatistic(stats->TimesSubmissive, 1);
 			}
 		} else {
 			int sub = 0;
@@ -563,25 +617,25 @@ namespace Papyrus::ThreadModel
 				if (Registry::IsNPC(a_positions[i])) {
 					switch (Registry::GetSex(a_positions[i])) {
 					case Registry::Sex::Male:
-						stats.AddStatistic(stats.PartnersMale, 1);
+						stats->AddStatistic(stats->PartnersMale, 1);
 						break;
 					case Registry::Sex::Female:
-						stats.AddStatistic(stats.PartnersFemale, 1);
+						stats->AddStatistic(stats->PartnersFemale, 1);
 						break;
 					case Registry::Sex::Futa:
-						stats.AddStatistic(stats.PartnersFuta, 1);
+						stats->AddStatistic(stats->PartnersFuta, 1);
 						break;
 					}
 				} else {
-					stats.AddStatistic(stats.PartnersCreature, 1);
+					stats->AddStatistic(stats->PartnersCreature, 1);
 				}
 			}
 			switch (sub) {
 			case -1:
-				stats.AddStatistic(stats.TimesDominant, 1);
+				stats->AddStatistic(stats->TimesDominant, 1);
 				break;
 			case 1:
-				stats.AddStatistic(stats.TimesSubmissive, 1);
+				stats->AddStatistic(stats->TimesSubmissive, 1);
 				break;
 			}
 		}
@@ -596,16 +650,16 @@ namespace Papyrus::ThreadModel
 			oral += stage->tags.HasTag(Registry::Tag::Oral);
 		}
 		if (vaginal) {
-			stats.AddStatistic(stats.TimesVaginal, 1);
-			stats.AddStatistic(stats.XP_Vaginal, vaginal * 1.25f);
+			stats->AddStatistic(stats->TimesVaginal, 1);
+			stats->AddStatistic(stats->XP_Vaginal, vaginal * 1.25f);
 		}
 		if (anal) {
-			stats.AddStatistic(stats.TimesAnal, 1);
-			stats.AddStatistic(stats.XP_Anal, anal * 1.25f);
+			stats->AddStatistic(stats->TimesAnal, 1);
+			stats->AddStatistic(stats->XP_Anal, anal * 1.25f);
 		}
 		if (oral) {
-			stats.AddStatistic(stats.TimesOral, 1);
-			stats.AddStatistic(stats.XP_Oral, oral * 1.25f);
+			stats->AddStatistic(stats->TimesOral, 1);
+			stats->AddStatistic(stats->XP_Oral, oral * 1.25f);
 		}
 	}
 
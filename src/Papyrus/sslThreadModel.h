@@ -30,6 +30,9 @@ namespace Papyrus::ThreadModel
 	RE::Actor* GetPhysicPartnerByType(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, int a_type);
 	std::vector<RE::Actor*> GetPhysicPartnersByType(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, int a_type);
 	float GetPhysicVelocity(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, RE::Actor* a_partner, int a_type);
+	float GetPhysicAcceleration(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, RE::Actor* a_partner, int a_type);
+	float GetPhysicTypeFraction(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, RE::Actor* a_position, RE::Actor* a_partner, int a_type, float a_seconds);
+	float GetPhysicTickRate(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst);
 
 	void AddExperience(VM* a_vm, StackID a_stackID, RE::TESQuest* a_qst, std::vector<RE::Actor*> a_positions,	
 		RE::BSFixedString a_scene, std::vector<RE::BSFixedString> a_playedstages);
@@ -56,6 +59,9 @@ namespace Papyrus::ThreadModel
 		REGISTERFUNC(GetPhysicPartnerByType, "sslThreadModel", true);
 		REGISTERFUNC(GetPhysicPartnersByType, "sslThreadModel", true);
 		REGISTERFUNC(GetPhysicVelocity, "sslThreadModel", true);
+		REGISTERFUNC(GetPhysicAcceleration, "sslThreadModel", true);
+		REGISTERFUNC(GetPhysicTypeFraction, "sslThreadModel", true);
+		REGISTERFUNC(GetPhysicTickRate, "sslThreadModel", true);
 
 		REGISTERFUNC(AddExperience, "sslThreadModel", true);
 		REGISTERFUNC(UpdateStatistics, "sslThreadModel", true);
@@ -1,10 +1,49 @@
 #include "Furniture.h"
 
+#include "Registry/Library.h"
+#include "Registry/Util/CellCrawler.h"
+#include "Registry/Util/Clearance.h"
+#include "Registry/Util/Nearest.h"
 #include "Registry/Util/RayCast.h"
 #include "Registry/Util/RayCast/ObjectBound.h"
 
 namespace Registry
 {
+	namespace
+	{
+		class HavokRayCaster : public Clearance::RayCaster
+		{
+		public:
+			HavokRayCaster(RE::TESObjectREFR* a_ignore) :
+				_ignore(a_ignore) {}
+
+			Clearance::Hit Cast(const glm::vec4& a_from, const glm::vec4& a_to) override
+			{
+				const auto res = Raycast::hkpCastRay(a_from, a_to, { _ignore });
+				return { res.hit, res.hitPos };
+			}
+
+		private:
+			RE::TESObjectREFR* _ignore;
+		};
+
+		/// Beds within range, keyed by their distance to a_center
+		std::vector<Nearest::Keyed<RE::TESObjectREFR*>> CollectBeds(const RE::NiPoint3& a_center, float a_radius, float a_radiusz)
+		{
+			std::vector<Nearest::Keyed<RE::TESObjectREFR*>> ret{};
+			CellCrawler::ForEachObjectInRange(a_center, a_radius, [&](RE::TESObjectREFR* ref) {
+				if (!ref)
+					return RE::BSContainer::ForEachResult::kContinue;
+				const auto position = ref->GetPosition();
+				if (a_radiusz > 0.0f && std::fabs(a_center.z - position.z) > a_radiusz)
+					return RE::BSContainer::ForEachResult::kContinue;
+				if (BedHandler::IsBed(ref))
+					ret.emplace_back(a_center.GetDistance(position), ref);
+				return RE::BSContainer::ForEachResult::kContinue;
+			});
+			return ret;
+		}
+	}
 
 #define MAPENTRY(value) \
 	{                     \
@@ -91,18 +130,23 @@ namespace Registry
 		const auto ninode = niobj ? niobj->AsNode() : nullptr;
 		if (!ninode)
 			return {};
-		const auto boundingbox = ObjectBound::MakeBoundingBox(ninode);
-		if (!boundingbox)
-			return {};
-		auto centerstart = boundingbox->GetCenterWorld();
-		centerstart.z = boundingbox->worldBoundMax.z;
-
-		const glm::vec4 tracestart{
-			centerstart.x,
-			centerstart.y,
-			centerstart.z,
-			0.0f
+		// The trace origin is only needed if some offset is not cached
+		std::optional<glm::vec4> tracestart{};
+		const auto getTraceStart = [&]() -> std::optional<glm::vec4> {
+			if (!tracestart) {
+				const auto boundingbox = ObjectBound::MakeBoundingBox(ninode);
+				if (!boundingbox)
+					return std::nullopt;
+				auto centerstart = boundingbox->GetCenterWorld();
+				centerstart.z = boundingbox->worldBoundMax.z;
+				tracestart.emplace(centerstart.x, centerstart.y, centerstart.z, 0.0f);
+			}
+			return tracestart;
 		};
+		static const auto order = Clearance::GetSampleOrder(Clearance::Params{}.radius, Clearance::Params{}.step);
+		HavokRayCaster caster{ a_ref };
+		auto budget = Settings::iClearanceRayBudget > 0 ? static_cast<uint32_t>(Settings::iClearanceRayBudget) : std::numeric_limits<uint32_t>::max();
+		const auto cache = ClearanceCache::GetSingleton();
 		const auto ref_coords = Coordinate(a_ref);
 		std::vector<std::pair<FurnitureType, std::vector<Coordinate>>> ret{};
 		for (auto&& [type, offsetlist] : _data) {
@@ -110,39 +154,32 @@ namespace Registry
 				continue;
 			}
 			std::vector<Coordinate> vec{};
-			for (auto&& offset : offsetlist) {
+			for (uint32_t i = 0; i < offsetlist.size(); i++) {
 				auto coordinates = ref_coords;
-				offset.Apply(coordinates);
-				// check the place surrounding the center to see if there is anything occupying it (walls, actors, etc)
-				// add some height to the base coordinate to avoid failing from hitting a rug or gold coin. 128 is roughly a NPC height in units
-				constexpr auto radius = 32.0f;
-				constexpr auto step = 8.0f;
-				const auto& center = coordinates.location;
-				const glm::vec4 traceend_base{ center.x, center.y, center.z + 16.0f, 0.0f };
-				const glm::vec4 traceend_up{ center.x, center.y, center.z + 128.0f, 0.0f };
-				for (float x = traceend_base.x - radius; x <= traceend_base.x + radius; x += step) {
-					for (float y = traceend_base.y - radius; y <= traceend_base.y + radius; y += step) {
-						glm::vec4 point(x, y, traceend_base.z, 0.0f);
-						if (glm::distance(point, traceend_base) > radius)
-							continue;
-						const auto resA = Raycast::hkpCastRay(tracestart, point, { a_ref });
-						if (resA.hit && glm::distance(resA.hitPos, point) > 8.0) {
-							goto __L_NEXT;
-						}
-						const auto resB = Raycast::hkpCastRay(point, traceend_up, { a_ref });
-						if (resB.hit) {
-							goto __L_NEXT;
-						}
+				offsetlist[i].Apply(coordinates);
+				auto clear = cache->Find(a_ref, type, i);
+				if (!clear) {
+					const auto start = getTraceStart();
+					if (!start)
+						return {};
+					const auto result = Clearance::Test(caster, *start, coordinates.location, order, {}, budget);
+					if (result == Clearance::Result::Unknown) {
+						logger::debug("Raycast budget exhausted testing furniture {:X}, remaining offsets are treated as blocked", a_ref->GetFormID());
+						continue;
 					}
+					clear = result == Clearance::Result::Clear;
+					cache->Insert(a_ref, type, i, *clear);
+				}
+				if (*clear) {
+					vec.push_back(coordinates);
 				}
-				// if we got here then the area around coordinates, incl a cone upwards is free of obstacles
-				vec.push_back(coordinates);
-__L_NEXT:;
 			}
 			if (!vec.empty()) {
 				ret.emplace_back(type, vec);
 			}
 		}
+		const auto counters = cache->GetCounters();
+		logger::debug("Clearance cache: {} hits, {} misses, {} invalidated", counters.hits, counters.misses, counters.invalidated);
 		return ret;
 	}
 
@@ -204,51 +241,213 @@ __L_NEXT:;
 
 	std::vector<RE::TESObjectREFR*> BedHandler::GetBedsInArea(RE::TESObjectREFR* a_center, float a_radius, float a_radiusz)
 	{
-		const auto center = a_center->GetPosition();
+		auto beds = CollectBeds(a_center->GetPosition(), a_radius, a_radiusz);
+		Nearest::SelectClosest(beds, beds.size());
 		std::vector<RE::TESObjectREFR*> ret{};
-		const auto add = [&](RE::TESObjectREFR* ref) {
-			if (!ref || !ref->GetBaseObject()->Is(RE::FormType::Furniture) && a_radiusz > 0.0f ? (std::fabs(center.z - ref->GetPosition().z) <= a_radiusz) : true)
-				if (Registry::BedHandler::IsBed(ref))
-					ret.push_back(ref);
-			return RE::BSContainer::ForEachResult::kContinue;
-		};
-		const auto TES = RE::TES::GetSingleton();
-		if (const auto interior = TES->interiorCell; interior) {
-			interior->ForEachReferenceInRange(center, a_radius, add);
-		} else if (const auto grids = TES->gridCells; grids) {
-			// Derived from: https://github.com/powerof3/PapyrusExtenderSSE
-			auto gridLength = grids->length;
-			if (gridLength > 0) {
-				float yPlus = center.y + a_radius;
-				float yMinus = center.y - a_radius;
-				float xPlus = center.x + a_radius;
-				float xMinus = center.x - a_radius;
-				for (uint32_t x = 0, y = 0; (x < gridLength && y < gridLength); x++, y++) {
-					const auto gridcell = grids->GetCell(x, y);
-					if (gridcell && gridcell->IsAttached()) {
-						auto cellCoords = gridcell->GetCoordinates();
-						if (!cellCoords)
-							continue;
-						float worldX = cellCoords->worldX;
-						float worldY = cellCoords->worldY;
-						if (worldX < xPlus && (worldX + 4096.0) > xMinus && worldY < yPlus && (worldY + 4096.0) > yMinus) {
-							gridcell->ForEachReferenceInRange(center, a_radius, add);
-						}
-					}
-				}
-			}
-			if (!ret.empty()) {
-				std::sort(ret.begin(), ret.end(), [&](RE::TESObjectREFR* a_refA, RE::TESObjectREFR* a_refB) {
-					return center.GetDistance(a_refA->GetPosition()) < center.GetDistance(a_refB->GetPosition());
-				});
-			}
+		ret.reserve(beds.size());
+		for (auto&& [_, ref] : beds) {
+			ret.push_back(ref);
 		}
 		return ret;
 	}
 
+	RE::TESObjectREFR* BedHandler::PickBedInArea(RE::TESObjectREFR* a_center, float a_radius, float a_radiusz, size_t a_candidates)
+	{
+		auto beds = CollectBeds(a_center->GetPosition(), a_radius, a_radiusz);
+		const auto count = Nearest::SelectClosest(beds, std::max<size_t>(a_candidates, 1));
+		return count ? Nearest::PickWeighted(std::span<const Nearest::Keyed<RE::TESObjectREFR*>>{ beds.data(), count }) : nullptr;
+	}
+
 	bool BedHandler::IsBed(const RE::TESObjectREFR* a_reference)
 	{
 		return GetBedType(a_reference) != FurnitureType::None;
 	}
 
+	void ClearanceCache::Register()
+	{
+		const auto script = RE::ScriptEventSourceHolder::GetSingleton();
+		script->AddEventSink<RE::TESCellAttachDetachEvent>(this);
+	}
+
+	uint64_t ClearanceCache::MakeKey(RE::FormID a_ref, FurnitureType a_type, uint32_t a_offset)
+	{
+		const auto type = static_cast<uint64_t>(std::countr_zero(static_cast<uint32_t>(a_type)));
+		return (static_cast<uint64_t>(a_ref) << 32) | (type << 24) | (a_offset & 0xFFFFFF);
+	}
+
+	std::optional<bool> ClearanceCache::Find(const RE::TESObjectREFR* a_ref, FurnitureType a_type, uint32_t a_offset)
+	{
+		const std::scoped_lock lock{ _m };
+		const auto where = _entries.find(MakeKey(a_ref->GetFormID(), a_type, a_offset));
+		if (where == _entries.end()) {
+			_counters.misses++;
+			return std::nullopt;
+		}
+		const auto& entry = where->second;
+		const auto ttl = std::chrono::duration<float>(Settings::fClearanceCacheTime);
+		const auto moved = entry.position.GetSquaredDistance(a_ref->GetPosition()) > 1.0f || std::abs(entry.angle - a_ref->GetAngleZ()) > 0.01f;
+		if (moved || Clock::now() - entry.time > ttl) {
+			_entries.erase(where);
+			_counters.invalidated++;
+			_counters.misses++;
+			return std::nullopt;
+		}
+		_counters.hits++;
+		return entry.clear;
+	}
+
+	void ClearanceCache::Insert(const RE::TESObjectREFR* a_ref, FurnitureType a_type, uint32_t a_offset, bool a_clear)
+	{
+		if (Settings::fClearanceCacheTime <= 0.0f)
+			return;
+		const std::scoped_lock lock{ _m };
+		_entries.insert_or_assign(MakeKey(a_ref->GetFormID(), a_type, a_offset), Entry{ a_ref->GetPosition(), a_ref->GetAngleZ(), Clock::now(), a_clear });
+	}
+
+	void ClearanceCache::Invalidate(RE::FormID a_ref)
+	{
+		const std::scoped_lock lock{ _m };
+		const auto first = _entries.lower_bound(static_cast<uint64_t>(a_ref) << 32);
+		const auto last = _entries.lower_bound((static_cast<uint64_t>(a_ref) + 1) << 32);
+		_counters.invalidated += std::distance(first, last);
+		_entries.erase(first, last);
+	}
+
+	void ClearanceCache::Clear()
+	{
+		const std::scoped_lock lock{ _m };
+		_entries.clear();
+	}
+
+	ClearanceCache::Counters ClearanceCache::GetCounters() const
+	{
+		const std::scoped_lock lock{ _m };
+		return _counters;
+	}
+
+	ClearanceCache::EventResult ClearanceCache::ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*)
+	{
+		if (!a_event || a_event->attached || !a_event->reference)
+			return EventResult::kContinue;
+
+		Invalidate(a_event->reference->GetFormID());
+		return EventResult::kContinue;
+	}
+
+	void FurnitureIndex::Register()
+	{
+		const auto script = RE::ScriptEventSourceHolder::GetSingleton();
+		script->AddEventSink<RE::TESCellAttachDetachEvent>(this);
+	}
+
+	int64_t FurnitureIndex::GetBucket(float a_x, float a_y)
+	{
+		const auto x = static_cast<int32_t>(std::floor(a_x / BUCKET_SIZE));
+		const auto y = static_cast<int32_t>(std::floor(a_y / BUCKET_SIZE));
+		return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+	}
+
+	std::vector<std::pair<RE::TESObjectREFR*, const FurnitureDetails*>> FurnitureIndex::Query(
+		const RE::NiPoint3& a_center,
+		float a_radius,
+		stl::enumeration<FurnitureType> a_types)
+	{
+		const std::scoped_lock lock{ _m };
+		{
+			const std::scoped_lock dirtylock{ _dirtyLock };
+			for (auto&& cell : _dirty) {
+				EraseCell(cell);
+			}
+			_dirty.clear();
+		}
+		CellCrawler::ForEachCellInRange(a_center, a_radius, [&](RE::TESObjectCELL* a_cell) {
+			if (!_cells.contains(a_cell->GetFormID()))
+				IndexCell(a_cell);
+		});
+		std::vector<std::pair<RE::TESObjectREFR*, const FurnitureDetails*>> ret{};
+		const auto radius2 = a_radius * a_radius;
+		const auto first = GetBucket(a_center.x - a_radius, a_center.y - a_radius);
+		const auto last = GetBucket(a_center.x + a_radius, a_center.y + a_radius);
+		for (auto x = first >> 32; x <= last >> 32; x++) {
+			for (auto y = static_cast<int32_t>(first); y <= static_cast<int32_t>(last); y++) {
+				const auto where = _grid.find((x << 32) | static_cast<uint32_t>(y));
+				if (where == _grid.end())
+					continue;
+				for (auto&& candidate : where->second) {
+					if (!a_types.any(candidate.types.get()) || candidate.position.GetSquaredDistance(a_center) > radius2)
+						continue;
+					const auto ref = RE::TESForm::LookupByID<RE::TESObjectREFR>(candidate.ref);
+					if (!ref || ref->IsDisabled() || ref->IsDeleted())
+						continue;
+					ret.emplace_back(ref, candidate.details);
+				}
+			}
+		}
+		return ret;
+	}
+
+	void FurnitureIndex::Clear()
+	{
+		const std::scoped_lock lock{ _m, _dirtyLock };
+		_cells.clear();
+		_grid.clear();
+		_dirty.clear();
+	}
+
+	void FurnitureIndex::IndexCell(RE::TESObjectCELL* a_cell)
+	{
+		const auto library = Library::GetSingleton();
+		auto& buckets = _cells[a_cell->GetFormID()];
+		size_t count = 0;
+		bool complete = true;
+		a_cell->ForEachReference([&](RE::TESObjectREFR* a_ref) {
+			const auto details = a_ref ? library->GetFurnitureDetails(a_ref) : nullptr;
+			if (!details) {
+				// Beds are recognized by their 3D, which may not be loaded yet
+				const auto base = a_ref ? a_ref->GetBaseObject() : nullptr;
+				if (base && base->Is(RE::FormType::Furniture) && !a_ref->Get3D())
+					complete = false;
+				return RE::BSContainer::ForEachResult::kContinue;
+			}
+			const auto position = a_ref->GetPosition();
+			const auto bucket = GetBucket(position.x, position.y);
+			_grid[bucket].push_back(Candidate{ a_ref->GetFormID(), a_cell->GetFormID(), position, library->GetFurnitureTypes(a_ref), details });
+			if (std::ranges::find(buckets, bucket) == buckets.end())
+				buckets.push_back(bucket);
+			count++;
+			return RE::BSContainer::ForEachResult::kContinue;
+		});
+		if (!complete) {
+			const std::scoped_lock lock{ _dirtyLock };
+			_dirty.push_back(a_cell->GetFormID());
+		}
+		logger::debug("Indexed {} furniture in cell {:X}{}", count, a_cell->GetFormID(), complete ? "" : ", some 3D is not loaded yet");
+	}
+
+	void FurnitureIndex::EraseCell(RE::FormID a_cell)
+	{
+		const auto where = _cells.find(a_cell);
+		if (where == _cells.end())
+			return;
+		for (auto&& bucket : where->second) {
+			auto& candidates = _grid[bucket];
+			std::erase_if(candidates, [&](const Candidate& it) { return it.cell == a_cell; });
+			if (candidates.empty())
+				_grid.erase(bucket);
+		}
+		_cells.erase(where);
+	}
+
+	FurnitureIndex::EventResult FurnitureIndex::ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*)
+	{
+		const auto cell = a_event && a_event->reference ? a_event->reference->GetParentCell() : nullptr;
+		if (!cell)
+			return EventResult::kContinue;
+
+		const std::scoped_lock lock{ _dirtyLock };
+		if (std::ranges::find(_dirty, cell->GetFormID()) == _dirty.end())
+			_dirty.push_back(cell->GetFormID());
+		return EventResult::kContinue;
+	}
+
 }	 // namespace Registry
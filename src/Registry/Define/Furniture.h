@@ -78,6 +78,13 @@ namespace Registry
 			stl::enumeration types = a_type;
 			return std::ranges::find_if(_data, [&](const auto& it) { return types.any(it.first); }) != _data.end();
 		}
+		stl::enumeration<FurnitureType> GetTypes() const
+		{
+			stl::enumeration<FurnitureType> ret{};
+			for (auto&& [type, _] : _data)
+				ret.set(type);
+			return ret;
+		}
 
 	private:
 		std::vector<std::pair<FurnitureType, std::vector<Coordinate>>> _data;
@@ -91,7 +98,100 @@ namespace Registry
 		_NODISCARD static FurnitureType GetBedType(const RE::TESObjectREFR* a_reference);
 
 		_NODISCARD static bool IsBed(const RE::TESObjectREFR* a_reference);
+		/// @return All beds in the area, closest first
 		_NODISCARD static std::vector<RE::TESObjectREFR*> GetBedsInArea(RE::TESObjectREFR* a_center, float a_radius, float a_radiusz);
+		/// @brief Randomly pick one of the a_candidates closest beds, closer ones being more likely
+		_NODISCARD static RE::TESObjectREFR* PickBedInArea(RE::TESObjectREFR* a_center, float a_radius, float a_radiusz, size_t a_candidates);
+	};
+
+	/// Results of the obstacle test around furniture offsets, keyed by reference, furniture type and offset index
+	/// An entry is dropped once its reference moves, its cell detaches or it is older than fClearanceCacheTime
+	class ClearanceCache :
+		public Singleton<ClearanceCache>,
+		public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+	{
+		using EventResult = RE::BSEventNotifyControl;
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		struct Counters
+		{
+			size_t hits{ 0 };
+			size_t misses{ 0 };
+			size_t invalidated{ 0 };
+		};
+
+	public:
+		void Register();
+
+		/// @return The cached result of the offset, or std::nullopt if it has to be sampled
+		_NODISCARD std::optional<bool> Find(const RE::TESObjectREFR* a_ref, FurnitureType a_type, uint32_t a_offset);
+		void Insert(const RE::TESObjectREFR* a_ref, FurnitureType a_type, uint32_t a_offset, bool a_clear);
+		void Invalidate(RE::FormID a_ref);
+		void Clear();
+		_NODISCARD Counters GetCounters() const;
+
+	private:
+		struct Entry
+		{
+			RE::NiPoint3 position;
+			float angle;
+			Clock::time_point time;
+			bool clear;
+		};
+		// Reference in the upper 32 bits, so all entries of a reference are adjacent
+		static uint64_t MakeKey(RE::FormID a_ref, FurnitureType a_type, uint32_t a_offset);
+
+		EventResult ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override;
+
+		mutable std::mutex _m;
+		std::map<uint64_t, Entry> _entries;
+		Counters _counters;
+	};
+
+	/// Furniture capable references of attached cells, bucketed in a uniform grid
+	/// A cell is indexed the first time it is queried and dropped once one of its references attaches or detaches
+	class FurnitureIndex :
+		public Singleton<FurnitureIndex>,
+		public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+	{
+		using EventResult = RE::BSEventNotifyControl;
+
+		static constexpr float BUCKET_SIZE = 512.0f;
+
+	public:
+		void Register();
+
+		/// @brief Find all indexed furniture within a_radius of a_center which support any of a_types
+		/// @return The references and their furniture details, in no particular order
+		_NODISCARD std::vector<std::pair<RE::TESObjectREFR*, const FurnitureDetails*>> Query(
+			const RE::NiPoint3& a_center, float a_radius, stl::enumeration<FurnitureType> a_types);
+		/// @brief Drop every indexed cell, required when furniture details are reloaded
+		void Clear();
+
+	private:
+		struct Candidate
+		{
+			RE::FormID ref;
+			RE::FormID cell;
+			RE::NiPoint3 position;
+			stl::enumeration<FurnitureType> types;
+			const FurnitureDetails* details;
+		};
+		static int64_t GetBucket(float a_x, float a_y);
+
+		void IndexCell(RE::TESObjectCELL* a_cell);
+		void EraseCell(RE::FormID a_cell);
+
+		EventResult ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override;
+
+		// Events only queue invalidations, as they may be sent while the game holds a lock the index needs when building a cell
+		std::mutex _dirtyLock;
+		std::vector<RE::FormID> _dirty;
+
+		std::mutex _m;
+		std::unordered_map<RE::FormID, std::vector<int64_t>> _cells;	// indexed cells and the buckets they occupy
+		std::unordered_map<int64_t, std::vector<Candidate>> _grid;
 	};
 
 } // namespace Registry
@@ -2,6 +2,9 @@
 
 namespace Registry
 {
+	static_assert(size_t(Expression::Profile::Modifier) == FaceFrame::Modifier && size_t(Expression::Profile::MoodType) == FaceFrame::MoodType &&
+								size_t(Expression::Profile::Total) == FaceFrame::Total);
+
 	Expression::Profile::Profile(const YAML::Node& a_src) :
 		id(a_src["id"].IsDefined() ? a_src["id"].as<std::string>() : "Missing Name"),
 		tags(a_src["tags"].IsDefined() ? a_src["tags"].as<std::vector<std::string>>() : std::vector<std::string>{}),
@@ -63,6 +66,22 @@ namespace Registry
 		}
 	}
 
+	Expression::Profile::Profile(ByteStream::Reader& a_src) :
+		id(a_src.ReadString()),
+		enabled(a_src.Read<bool>())
+	{
+		for (auto n = a_src.ReadVarint(); n > 0; n--) {
+			tags.AddTag(RE::BSFixedString{ a_src.ReadString() });
+		}
+		for (auto&& levels : data) {
+			const auto count = a_src.ReadVarint();
+			if (count * sizeof(levels[0]) > a_src.Remaining())
+				throw std::exception("Invalid level count");
+			levels.resize(count);
+			a_src.ReadArray(std::span{ levels });
+		}
+	}
+
 	YAML::Node Expression::Profile::AsYAML() const
 	{
 		YAML::Node ret;
@@ -79,6 +98,45 @@ namespace Registry
 		return ret;
 	}
 
+	void Expression::Profile::Write(ByteStream::Writer& a_dst) const
+	{
+		a_dst.WriteString(id.c_str());
+		a_dst.Write(enabled);
+		const auto tagvec = tags.AsVector();
+		a_dst.WriteVarint(tagvec.size());
+		for (auto&& tag : tagvec) {
+			a_dst.WriteString(tag.c_str());
+		}
+		for (auto&& levels : data) {
+			a_dst.WriteVarint(levels.size());
+			a_dst.WriteArray(std::span{ levels });
+		}
+	}
+
+	size_t Expression::Profile::GetChecksum() const
+	{
+		std::vector<std::byte> buffer{};
+		ByteStream::Writer writer{ buffer };
+		Write(writer);
+		const auto ret = std::hash<std::string_view>{}({ reinterpret_cast<const char*>(buffer.data()), buffer.size() });
+		return ret ? ret : 1;
+	}
+
+	void Expression::Profile::Compile()
+	{
+		auto compiled = std::make_shared<Curves>();
+		for (size_t sex = 0; sex < RE::SEXES::kTotal; sex++) {
+			(*compiled)[sex] = FaceFrame::Curve{ data[sex] };
+		}
+		curves.ptr.store(std::move(compiled));
+	}
+
+	std::array<float, Expression::Profile::Total> Expression::Profile::Evaluate(RE::SEXES::SEX a_sex, float a_intensity) const
+	{
+		const auto compiled = curves.ptr.load();
+		return compiled ? (*compiled)[a_sex].Evaluate(a_intensity) : std::array<float, Total>{};
+	}
+
 	Expression::Profile Expression::GetDefaultAfraid()
 	{
 		Profile ret{ RE::BSFixedString{ "Afraid" } };
@@ -259,25 +317,39 @@ namespace Registry
 
 	bool Expression::RenameProfile(const RE::BSFixedString& a_id, const RE::BSFixedString& a_newid)
 	{
+		const std::unique_lock lock{ _m };
 		auto where = _profiles.find(a_id);
 		if (where == _profiles.end())
 			return false;
 
-		_profiles[a_newid] = where->second;
+		auto& profile = _profiles[a_newid] = where->second;
+		profile.id = a_newid;
+		profile.checksum = 0;
 		_profiles.erase(where);
 		return true;
 	}
 
 	bool Expression::CreateProfile(const RE::BSFixedString& a_id)
 	{
+		const std::unique_lock lock{ _m };
 		auto where = _profiles.find(a_id);
 		if (where != _profiles.end())
 			return false;
 
 		_profiles[a_id] = Profile{ a_id };
+		_profiles[a_id].Compile();
 		return true;
 	}
 
+	std::optional<std::array<float, Expression::Profile::Total>> Expression::EvaluateProfile(const RE::BSFixedString& a_id, RE::SEXES::SEX a_sex, float a_intensity) const
+	{
+		const std::shared_lock lock{ _m };
+		const auto where = _profiles.find(a_id);
+		if (where == _profiles.end())
+			return std::nullopt;
+		return where->second.Evaluate(a_sex, a_intensity);
+	}
+
 	bool Expression::ForEachProfile(std::function<bool(Profile&)> a_func)
 	{
 		for (auto&& [id, profile] : _profiles) {
@@ -291,6 +363,8 @@ namespace Registry
 	void Expression::Initialize()
 	{
 		logger::info("Loading Expressions");
+		const std::unique_lock lock{ _m };
+		const auto begin = std::chrono::steady_clock::now();
 		const auto path_legacy = fs::path{ "Data\\SKSE\\Plugins\\SexLab\\" };
 		bool has_new = false;
 		if (fs::exists(path_legacy) && fs::is_directory(path_legacy)) {
@@ -304,30 +378,266 @@ namespace Registry
 					const auto jsonfile = nlohmann::json::parse(std::ifstream(file.path().string()));
 					const auto profile = Profile{ jsonfile };
 					_profiles[profile.id] = std::move(profile);
+					has_new = true;
 					logger::info("Added legacy expression {}. You may delete this file now", filename);
 				} catch (const std::exception& e) {
 					logger::info("Failed to update {}, Error = {}", filename, e.what());
 				}
 			}
 		}
+		size_t cached = 0, parsed = 0;
 		if (fs::exists(EXPRESSION_PATH) && fs::is_directory(EXPRESSION_PATH)) {
-			for (auto& file : fs::directory_iterator{ path_legacy }) {
+			struct Job
+			{
+				fs::directory_entry file;
+				std::string filename;
+				std::optional<Profile> profile{ std::nullopt };
+				std::string error{};
+			};
+			auto cache = ReadCache();
+			std::vector<Job> jobs{};
+			for (auto& file : fs::directory_iterator{ EXPRESSION_PATH }) {
+				if (!file.is_regular_file())
+					continue;
 				auto filename = file.path().filename().string();
-				try {
-					logger::info("Attempting to parse expression file {}", filename);
-					const auto yaml = YAML::LoadFile(file.path().string());
-					const auto profile = Profile{ yaml };
+				const auto where = cache.find(filename);
+				if (where != cache.end() && where->second.first.Matches(file)) {
+					auto& profile = where->second.second;
+					profile.checksum = profile.GetChecksum();
+					_files.emplace(filename, where->second.first);
 					_profiles[profile.id] = std::move(profile);
-					logger::info("Added expression {}", filename);
+					cached++;
+					continue;
+				}
+				jobs.emplace_back(file, std::move(filename));
+			}
+			std::for_each(std::execution::par, jobs.begin(), jobs.end(), [](Job& job) {
+				try {
+					const auto yaml = YAML::LoadFile(job.file.path().string());
+					job.profile.emplace(yaml);
+					job.profile->checksum = job.profile->GetChecksum();
 				} catch (const std::exception& e) {
-					logger::info("Failed to load {}, Error = {}", filename, e.what());
+					job.error = e.what();
 				}
+			});
+			for (auto&& job : jobs) {
+				if (!job.profile) {
+					logger::info("Failed to load {}, Error = {}", job.filename, job.error);
+					continue;
+				}
+				_files.insert_or_assign(job.filename, MakeStamp(job.file, job.profile->id));
+				_profiles[job.profile->id] = std::move(*job.profile);
+				logger::info("Added expression {}", job.filename);
+				parsed++;
+			}
+			if (parsed > 0 || cached != cache.size()) {
+				WriteCache();
 			}
 		}
 		if (has_new) {
 			Save(false);
 		}
-		logger::info("Finished loading expressions");
+		for (auto&& [id, profile] : _profiles) {
+			profile.Compile();
+		}
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+		logger::info("Finished loading expressions in {}ms ({} load); {} from cache, {} parsed", duration.count(), parsed ? "cold" : "warm", cached, parsed);
+	}
+
+	Expression::FileStamp Expression::MakeStamp(const fs::directory_entry& a_file, const RE::BSFixedString& a_id)
+	{
+		return FileStamp{ a_file.last_write_time().time_since_epoch().count(), a_file.file_size(), a_id };
+	}
+
+	bool Expression::FileStamp::Matches(const fs::directory_entry& a_file) const
+	{
+		std::error_code ec{};
+		const auto filetime = a_file.last_write_time(ec);
+		const auto filesize = a_file.file_size(ec);
+		return !ec && filetime.time_since_epoch().count() == time && filesize == size;
+	}
+
+	std::map<std::string, std::pair<Expression::FileStamp, Expression::Profile>> Expression::ReadCache() const
+	{
+		std::map<std::string, std::pair<FileStamp, Profile>> ret{};
+		std::ifstream stream{ CACHE_PATH, std::ios::binary };
+		if (!stream.is_open())
+			return ret;
+		const std::vector<char> content{ std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+		try {
+			ByteStream::Reader reader{ std::as_bytes(std::span{ content }) };
+			if (reader.Read<uint32_t>() != CACHE_MAGIC || reader.Read<uint32_t>() != CACHE_VERSION)
+				throw std::exception("Invalid cache header");
+			for (auto n = reader.ReadVarint(); n > 0; n--) {
+				auto filename = reader.ReadString();
+				const auto time = reader.Read<int64_t>();
+				const auto size = reader.ReadVarint();
+				Profile profile{ reader };
+				FileStamp stamp{ time, size, profile.id };
+				ret.emplace(std::move(filename), std::make_pair(std::move(stamp), std::move(profile)));
+			}
+		} catch (const std::exception& e) {
+			logger::info("Discarding expression cache, Error = {}", e.what());
+			ret.clear();
+		}
+		return ret;
+	}
+
+	void Expression::WriteCache() const
+	{
+		std::vector<std::byte> buffer{};
+		ByteStream::Writer writer{ buffer };
+		writer.Write(CACHE_MAGIC);
+		writer.Write(CACHE_VERSION);
+		std::vector<std::pair<const std::string*, const Profile*>> entries{};
+		for (auto&& [filename, stamp] : _files) {
+			const auto where = _profiles.find(stamp.id);
+			if (where == _profiles.end() || where->second.isdefault)
+				continue;
+			entries.emplace_back(&filename, &where->second);
+		}
+		writer.WriteVarint(entries.size());
+		for (auto&& [filename, profile] : entries) {
+			const auto& stamp = _files.at(*filename);
+			writer.WriteString(*filename);
+			writer.Write(stamp.time);
+			writer.WriteVarint(stamp.size);
+			profile->Write(writer);
+		}
+		std::ofstream stream{ CACHE_PATH, std::ios::binary | std::ios::trunc };
+		stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		if (!stream.good()) {
+			logger::error("Failed to write expression cache {}", CACHE_PATH);
+		}
+	}
+
+	ExpressionScheduler::~ExpressionScheduler()
+	{
+		{
+			const std::scoped_lock lock{ _m };
+			_stop = true;
+		}
+		_cv.notify_all();
+		if (_t.joinable())
+			_t.join();
+	}
+
+	void ExpressionScheduler::Register(RE::Actor* a_actor, const RE::BSFixedString& a_profile, float a_intensity)
+	{
+		const auto base = a_actor->GetActorBase();
+		const auto sex = base && base->GetSex() == RE::SEXES::kFemale ? RE::SEXES::kFemale : RE::SEXES::kMale;
+		{
+			const std::scoped_lock lock{ _m };
+			_actors.insert_or_assign(a_actor->GetFormID(), State{ a_profile, sex, a_intensity });
+			if (!_t.joinable())
+				_t = std::thread{ &ExpressionScheduler::Run, this };
+		}
+		_cv.notify_all();
+	}
+
+	bool ExpressionScheduler::SetIntensity(RE::Actor* a_actor, float a_intensity)
+	{
+		const std::scoped_lock lock{ _m };
+		const auto where = _actors.find(a_actor->GetFormID());
+		if (where == _actors.end())
+			return false;
+		where->second.intensity = a_intensity;
+		return true;
+	}
+
+	void ExpressionScheduler::Unregister(RE::Actor* a_actor)
+	{
+		{
+			const std::scoped_lock lock{ _m };
+			if (!_actors.erase(a_actor->GetFormID()))
+				return;
+		}
+		SKSE::GetTaskInterface()->AddTask([id = a_actor->GetFormID()]() {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(id);
+			const auto data = actor ? actor->GetFaceGenAnimationData() : nullptr;
+			if (!data)
+				return;
+			data->ClearExpressionOverride();
+			data->Reset(0.0f, true, true, true, false);
+		});
+	}
+
+	bool ExpressionScheduler::IsRegistered(RE::Actor* a_actor) const
+	{
+		const std::scoped_lock lock{ _m };
+		return _actors.contains(a_actor->GetFormID());
+	}
+
+	void ExpressionScheduler::Clear()
+	{
+		const std::scoped_lock lock{ _m };
+		_actors.clear();
+	}
+
+	void ExpressionScheduler::Run()
+	{
+		std::unique_lock lock{ _m };
+		while (!_stop) {
+			_cv.wait(lock, [this]() { return _stop || !_actors.empty(); });
+			if (_stop)
+				break;
+			// One task per interval, applying every registered actor's frame on the main thread
+			SKSE::GetTaskInterface()->AddTask([this, actors = _actors]() { Apply(actors); });
+			const auto interval = std::chrono::duration<float>(std::max(Settings::fExpressionDelay, 0.1f));
+			_cv.wait_for(lock, interval, [this]() { return _stop; });
+		}
+	}
+
+	void ExpressionScheduler::Apply(const std::unordered_map<RE::FormID, State>& a_actors)
+	{
+		constexpr float EPSILON = 0.005f;
+		const auto expressions = Expression::GetSingleton();
+		size_t written = 0;
+		for (auto&& [id, state] : a_actors) {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(id);
+			const auto data = actor ? actor->GetFaceGenAnimationData() : nullptr;
+			if (!data)
+				continue;
+			const auto evaluated = expressions->EvaluateProfile(state.profile, state.sex, state.intensity);
+			if (!evaluated)
+				continue;
+			const auto& target = *evaluated;
+			// The facegen update reads and writes the same keyframes on its own thread
+			RE::BSSpinLockGuard guard{ data->lock };
+			auto& phonemes = data->phenomeKeyFrame;
+			auto& modifiers = data->modifierKeyFrame;
+			auto& moods = data->expressionKeyFrame;
+			FaceFrame::Frame current{};
+			for (size_t i = 0; i < FaceFrame::Modifier - FaceFrame::Phoneme && i < phonemes.count; i++) {
+				current[FaceFrame::Phoneme + i] = phonemes.values[i];
+			}
+			for (size_t i = 0; i < FaceFrame::MoodType - FaceFrame::Modifier && i < modifiers.count; i++) {
+				current[FaceFrame::Modifier + i] = modifiers.values[i];
+			}
+			for (size_t i = 0; i < moods.count; i++) {
+				if (moods.values[i] > 0.0f) {
+					current[FaceFrame::MoodType] = static_cast<float>(i);
+					current[FaceFrame::MoodValue] = moods.values[i];
+					break;
+				}
+			}
+			const auto changed = FaceFrame::Diff(current, target, EPSILON);
+			for (size_t i = 0; i < FaceFrame::MoodType; i++) {
+				if (!changed[i])
+					continue;
+				if (i < FaceFrame::Modifier) {
+					if (i - FaceFrame::Phoneme < phonemes.count)
+						phonemes.values[i - FaceFrame::Phoneme] = target[i];
+				} else if (i - FaceFrame::Modifier < modifiers.count) {
+					modifiers.values[i - FaceFrame::Modifier] = target[i];
+				}
+			}
+			if (changed[FaceFrame::MoodType]) {
+				data->SetExpressionOverride(static_cast<uint32_t>(target[FaceFrame::MoodType]), target[FaceFrame::MoodValue]);
+			}
+			written += changed.count();
+		}
+		logger::debug("Expression pass over {} actors wrote {} channels", a_actors.size(), written);
 	}
 
 	void Expression::Save(bool verbose)
@@ -335,15 +645,29 @@ namespace Registry
 		if (verbose) {
 			logger::info("Saving expressions");
 		}
+		size_t written = 0;
 		for (auto&& [id, profile] : _profiles) {
 			if (profile.isdefault)
 				continue;
-			const auto file = profile.AsYAML();
-			std::ofstream fout(fmt::format("{}\\{}", EXPRESSION_PATH, id));
-			fout << file;
+			const auto checksum = profile.GetChecksum();
+			if (checksum == profile.checksum)
+				continue;
+			const auto filename = std::string{ id.c_str() };
+			const auto path = fs::path{ EXPRESSION_PATH } / filename;
+			{
+				const auto file = profile.AsYAML();
+				std::ofstream fout(path);
+				fout << file;
+			}
+			profile.checksum = checksum;
+			_files.insert_or_assign(filename, MakeStamp(fs::directory_entry{ path }, id));
+			written++;
+		}
+		if (written > 0) {
+			WriteCache();
 		}
 		if (verbose) {
-			logger::info("Finished saving expressions");
+			logger::info("Finished saving expressions, {} profiles changed", written);
 		}
 	}
 
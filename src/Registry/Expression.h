@@ -1,6 +1,10 @@
 #pragma once
 
+#include <shared_mutex>
+
 #include "Registry/Define/Tags.h"
+#include "Registry/Util/ByteStream.h"
+#include "Registry/Util/FaceFrame.h"
 
 namespace Registry
 {
@@ -8,6 +12,9 @@ namespace Registry
 		public Singleton<Expression>
 	{
 		static inline const auto EXPRESSION_PATH{ CONFIGPATH("Expressions") };
+		static inline const auto CACHE_PATH{ CONFIGPATH("Expressions.cache") };
+		static constexpr uint32_t CACHE_MAGIC{ 'SLEX' };
+		static constexpr uint32_t CACHE_VERSION{ 1 };
 
 	public:
 		struct Profile
@@ -28,9 +35,20 @@ namespace Registry
 				id(a_id) { assert(!a_id.empty()); };
 			Profile(const YAML::Node& a_src);
 			Profile(const nlohmann::json& a_src);
+			Profile(ByteStream::Reader& a_src);
 			~Profile() = default;
 
 			YAML::Node AsYAML() const;
+			void Write(ByteStream::Writer& a_dst) const;
+			/// @brief Hash of all persistent data, used to detect changes since the last save
+			_NODISCARD size_t GetChecksum() const;
+
+			/// @brief Rebuild the interpolation tables, required after data has been changed
+			void Compile();
+			/// @brief Blend the two levels surrounding a_intensity
+			/// @param a_intensity 0 for the first level, 1 for the last
+			/// @return The interpolated values, the mood type is taken from the closer level
+			std::array<float, Total> Evaluate(RE::SEXES::SEX a_sex, float a_intensity) const;
 
 		public:
 			RE::BSFixedString id;
@@ -38,6 +56,27 @@ namespace Registry
 			std::vector<std::array<float, Total>> data[RE::SEXES::kTotal]{};
 			bool enabled{ true };
 			bool isdefault{ false};
+			size_t checksum{ 0 };	 // checksum of the state on disk, 0 if unsaved
+
+		private:
+			using Curves = std::array<FaceFrame::Curve, RE::SEXES::kTotal>;
+			// Immutable once published, Compile() swaps in a new set so Evaluate() never observes a partial rebuild
+			// std::atomic is not copyable, a copied profile shares the curves published at the time of the copy
+			struct CurvesPtr
+			{
+				CurvesPtr() = default;
+				CurvesPtr(const CurvesPtr& a_rhs) :
+					ptr(a_rhs.ptr.load()) {}
+				CurvesPtr& operator=(const CurvesPtr& a_rhs)
+				{
+					ptr.store(a_rhs.ptr.load());
+					return *this;
+				}
+				~CurvesPtr() = default;
+
+				std::atomic<std::shared_ptr<const Curves>> ptr{};
+			};
+			CurvesPtr curves{};
 		};
 		static Profile GetDefaultAfraid();
 		static Profile GetDefaultAngry();
@@ -53,6 +92,9 @@ namespace Registry
 		Profile* GetProfile(const RE::BSFixedString& a_id);
 		bool RenameProfile(const RE::BSFixedString& a_id, const RE::BSFixedString& a_newid);
 		bool CreateProfile(const RE::BSFixedString& a_id);
+		/// @brief Evaluate a profile by id, safe to call while profiles are being renamed or created on another thread
+		/// @return The blended values, or nullopt if there is no profile a_id
+		std::optional<std::array<float, Profile::Total>> EvaluateProfile(const RE::BSFixedString& a_id, RE::SEXES::SEX a_sex, float a_intensity) const;
 
 		bool ForEachProfile(std::function<bool(Profile&)> a_func);
 
@@ -60,6 +102,24 @@ namespace Registry
 		void Save(bool verbose = true);
 
 	private:
+		struct FileStamp
+		{
+			int64_t time;
+			uintmax_t size;
+			RE::BSFixedString id;
+
+			_NODISCARD bool Matches(const fs::directory_entry& a_file) const;
+		};
+		static FileStamp MakeStamp(const fs::directory_entry& a_file, const RE::BSFixedString& a_id);
+
+		std::map<std::string, std::pair<FileStamp, Profile>> ReadCache() const;
+		void WriteCache() const;
+
+		std::map<std::string, FileStamp> _files;	// yaml files in EXPRESSION_PATH and the profile they define
+
+		// Guards insertion and removal of profiles against the expression pass on the main thread
+		mutable std::shared_mutex _m{};
+
 #define PROFILE_DEFAULT(f) []() { auto ret = f(); return std::pair{ret.id, ret}; }()
 		std::map<RE::BSFixedString, Profile, FixedStringCompare> _profiles{
 			PROFILE_DEFAULT(GetDefaultAfraid),
@@ -74,4 +134,39 @@ namespace Registry
 #undef PROFILE_DEFAULT
 	};
 
+	/// Owns the facial expressions of all animating actors
+	/// Once per fExpressionDelay, every actor's target frame is evaluated and only channels differing from the actor's current face are written
+	/// The pass runs as a single task on the main thread
+	class ExpressionScheduler :
+		public Singleton<ExpressionScheduler>
+	{
+		struct State
+		{
+			RE::BSFixedString profile;
+			RE::SEXES::SEX sex;
+			float intensity;
+		};
+
+	public:
+		~ExpressionScheduler();
+
+		void Register(RE::Actor* a_actor, const RE::BSFixedString& a_profile, float a_intensity);
+		bool SetIntensity(RE::Actor* a_actor, float a_intensity);
+		/// @brief Stop updating a_actor and reset its face
+		void Unregister(RE::Actor* a_actor);
+		bool IsRegistered(RE::Actor* a_actor) const;
+		/// @brief Forget all registrations, the actors belong to the game being left
+		void Clear();
+
+	private:
+		void Run();
+		static void Apply(const std::unordered_map<RE::FormID, State>& a_actors);
+
+		mutable std::mutex _m;
+		std::condition_variable _cv;
+		std::unordered_map<RE::FormID, State> _actors;
+		bool _stop{ false };
+		std::thread _t;
+	};
+
 }	 // namespace Registry
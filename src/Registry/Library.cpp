@@ -78,13 +78,13 @@ namespace Registry
 		logger::info("Loaded {} Packages ({} scenes | {} categories) in {}ms", packages.size(), GetSceneCount(), scenes.size(), ms_double.count());
 
 		const auto furniturepath = fs::path{ CONFIGPATH("Furniture") };
-		if (!fs::exists(scenepath, ec) || fs::is_empty(scenepath, ec)) {
+		if (!fs::exists(furniturepath, ec) || fs::is_empty(furniturepath, ec)) {
 			const auto msg = ec ? fmt::format("An error occured while attempting to read furniture info: {}", ec.message()) :
-														fmt::format("Unable to load furnitures. Folder {} is empty or does not exist.", scenepath.string());
+														fmt::format("Unable to load furnitures. Folder {} is empty or does not exist.", furniturepath.string());
 			logger::critical("{}", msg);
 		} else {
 			const std::unique_lock lock{ read_write_lock };
-			for (auto& file : fs::directory_iterator{ scenepath }) {
+			for (auto& file : fs::directory_iterator{ furniturepath }) {
 				if (auto ext = file.path().extension(); ext != ".yml" && ext != ".yaml") {
 					continue;
 				}
@@ -102,9 +102,14 @@ namespace Registry
 				}
 			}
 		}
+		{
+			const std::unique_lock lock{ furniture_cache_lock };
+			furniture_cache.clear();
+		}
+		FurnitureIndex::GetSingleton()->Clear();
 		const auto t3 = std::chrono::high_resolution_clock::now();
 		ms_double = t3 - t2;
-		logger::info("Loaded {} Furnitures in {}ms", packages.size(), GetSceneCount(), scenes.size(), ms_double.count());
+		logger::info("Loaded {} Furnitures in {}ms", furnitures.size(), ms_double.count());
 		logger::info("Initialized Data");
 	}
 
@@ -163,6 +168,17 @@ namespace Registry
 		return ret;
 	}
 
+	bool Library::HasScenes(std::vector<PositionFragment> a_fragments) const
+	{
+		std::stable_sort(a_fragments.begin(), a_fragments.end());
+		const auto hash = CombineFragments(a_fragments);
+		const std::shared_lock lock{ read_write_lock };
+		const auto where = this->scenes.find(hash);
+		if (where == this->scenes.end())
+			return false;
+		return std::ranges::any_of(where->second, [](Scene* a_scene) { return a_scene->IsEnabled() && !a_scene->IsPrivate(); });
+	}
+
 	size_t Library::GetSceneCount() const
 	{
 		const std::shared_lock lock{ read_write_lock };
@@ -250,27 +266,62 @@ namespace Registry
 	}
 	
 	const FurnitureDetails* Library::GetFurnitureDetails(const RE::TESObjectREFR* a_ref) const
+	{
+		return ClassifyFurniture(a_ref).details;
+	}
+
+	stl::enumeration<FurnitureType> Library::GetFurnitureTypes(const RE::TESObjectREFR* a_ref) const
+	{
+		return ClassifyFurniture(a_ref).types;
+	}
+
+	Library::FurnitureClassification Library::ClassifyFurniture(const RE::TESObjectREFR* a_ref) const
 	{
 		if (a_ref->Is(RE::FormType::ActorCharacter)) {
-			return nullptr;
+			return {};
+		}
+		const auto base = a_ref->GetObjectReference();
+		if (!base) {
+			return {};
 		}
-		const auto ref = a_ref->GetObjectReference();
-		if (const auto tesmodel = ref ? ref->As<RE::TESModel>() : nullptr) {
+		{
+			std::shared_lock lock{ furniture_cache_lock };
+			if (const auto where = furniture_cache.find(base->GetFormID()); where != furniture_cache.end()) {
+				return where->second;
+			}
+		}
+		FurnitureClassification ret{};
+		if (const auto tesmodel = base->As<RE::TESModel>()) {
 			std::shared_lock lock{ read_write_lock };
 			const auto where = furnitures.find(tesmodel->model);
 			if (where != furnitures.end()) {
-				return where->second.get();
+				ret.details = where->second.get();
+			}
+		}
+		if (!ret.details) {
+			switch (BedHandler::GetBedType(a_ref)) {
+			case FurnitureType::BedSingle:
+				ret.details = &offset_bedsingle;
+				break;
+			case FurnitureType::BedDouble:
+				ret.details = &offset_beddouble;
+				break;
+			case FurnitureType::BedRoll:
+				ret.details = &offset_bedroll;
+				break;
+			default:
+				// Beds are recognized by their 3D, an unloaded reference cannot be classified yet
+				if (!a_ref->Get3D())
+					return ret;
+				break;
 			}
 		}
-		switch (BedHandler::GetBedType(a_ref)) {
-		case FurnitureType::BedSingle:
-			return &offset_bedsingle;
-		case FurnitureType::BedDouble:
-			return &offset_beddouble;
-		case FurnitureType::BedRoll:
-			return &offset_bedroll;
+		if (ret.details) {
+			ret.types = ret.details->GetTypes();
 		}
-		return nullptr;
+		std::unique_lock lock{ furniture_cache_lock };
+		furniture_cache.emplace(base->GetFormID(), ret);
+		return ret;
 	}
 
 }
@@ -19,11 +19,14 @@ namespace Registry
 		_NODISCARD const Scene* GetSceneByID(const RE::BSFixedString& a_id) const;
 		_NODISCARD Scene* GetSceneByID_Mutable(const RE::BSFixedString& a_id) const;
 		_NODISCARD size_t GetSceneCount() const;
+		/// @brief If there is any enabled, public scene for a group of actors with the given fragments
+		_NODISCARD bool HasScenes(std::vector<PositionFragment> a_fragments) const;
 
 		void ForEachScene(std::function<bool(const Scene*)> a_visitor) const;
 
 	public:
 		_NODISCARD const FurnitureDetails* GetFurnitureDetails(const RE::TESObjectREFR* a_ref) const;
+		_NODISCARD stl::enumeration<FurnitureType> GetFurnitureTypes(const RE::TESObjectREFR* a_ref) const;
 
 	public:
 		void Save();
@@ -37,6 +40,15 @@ namespace Registry
 		FurnitureDetails offset_beddouble{ FurnitureType::BedDouble, Coordinate(std::vector{ 0.0f, -31.0f, 40.0f, 0.0f }) };
 		std::map<RE::BSFixedString, std::unique_ptr<FurnitureDetails>, FixedStringCompare> furnitures;	// custom furniture details
 
+		struct FurnitureClassification
+		{
+			const FurnitureDetails* details;
+			stl::enumeration<FurnitureType> types;
+		};
+		_NODISCARD FurnitureClassification ClassifyFurniture(const RE::TESObjectREFR* a_ref) const;
+		mutable std::shared_mutex furniture_cache_lock{};
+		mutable std::unordered_map<RE::FormID, FurnitureClassification> furniture_cache;	// resolved furniture details by base object
+
 		std::map<RE::BSFixedString, Scene*, FixedStringCompare> scene_map;	// Mapping every scene to their respective id for quick lookup
 		std::vector<std::unique_ptr<AnimPackage>> packages;									// All registered packages, containing all available scenes
 		std::unordered_map<FragmentHash, std::vector<Scene*>> scenes;				// The main lookup table using LibraryKeys
@@ -1,9 +1,35 @@
 #include "Physics.h"
 
-#include "Util/Premutation.h"
+#include "Util/InteractionRecord.h"
+#include "Util/NodeNames.h"
 
 namespace Registry
 {
+	static_assert(std::to_underlying(Sex::Male) == Interaction::SexFlag::Male &&
+								std::to_underlying(Sex::Female) == Interaction::SexFlag::Female &&
+								std::to_underlying(Sex::Futa) == Interaction::SexFlag::Futa);
+
+	namespace
+	{
+		Interaction::Thresholds GetThresholds()
+		{
+			return Interaction::Thresholds{
+				.distanceHead = Settings::fDistanceHead,
+				.distanceFoot = Settings::fDistanceFoot,
+				.distanceHand = Settings::fDistanceHand,
+				.distanceCrotch = Settings::fDistanceCrotch,
+				.anglePenetration = Settings::fAnglePenetration,
+				.angleGrinding = Settings::fAngleGrinding,
+				.angleMouth = Settings::fAngleMouth,
+			};
+		}
+
+		uint8_t GetHysteresis(int32_t a_ticks)
+		{
+			return static_cast<uint8_t>(std::clamp<int32_t>(a_ticks, 1, UINT8_MAX));
+		}
+	}
+
 	Physics::Position::Nodes::Nodes(const RE::Actor* a_actor, bool a_alternatenodes)
 	{
 		const auto obj = a_actor->Get3D();
@@ -11,259 +37,95 @@ namespace Registry
 			const auto msg = fmt::format("Unable to retrieve 3D of actor {:X}", a_actor->GetFormID());
 			throw std::exception(msg.c_str());
 		}
-		head = RE::NiPointer{ obj->GetObjectByName(HEAD) };
+		const auto traverse = [](RE::NiAVObject* a_root, auto&& a_visit) {
+			RE::BSVisit::TraverseScenegraphObjects(a_root, [&](RE::NiAVObject* a_obj) {
+				const auto name = a_obj->name.c_str();
+				return a_visit(a_obj, name ? std::string_view{ name } : std::string_view{}) ? RE::BSVisit::BSVisitControl::kStop : RE::BSVisit::BSVisitControl::kContinue;
+			});
+		};
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		const auto nodes = a_alternatenodes ? NodeNames::ALTERNATE_NODES.Resolve(obj, traverse) : NodeNames::DEFAULT_NODES.Resolve(obj, traverse);
+		const auto t2 = std::chrono::high_resolution_clock::now();
+		std::chrono::duration<double, std::micro> us_double = t2 - t1;
+		logger::debug("Resolved nodes of actor {:X} in {:.1f}us", a_actor->formID, us_double.count());
+
+		head = RE::NiPointer{ nodes[NodeFrame::Head] };
 		if (!head) {
 			logger::info("Actor {:X} is missing head node (This may be expected for creature actors)", a_actor->formID);
 		}
-		pelvis = RE::NiPointer{ obj->GetObjectByName(PELVIS) };
-		spine_lower = RE::NiPointer{ obj->GetObjectByName(SPINELOWER) };
+		pelvis = RE::NiPointer{ nodes[NodeFrame::Pelvis] };
+		spine_lower = RE::NiPointer{ nodes[NodeFrame::SpineLower] };
 		if (!pelvis || !spine_lower) {
 			throw std::exception("Missing mandatory 3d object (body)");
 		}
-		hand_left = RE::NiPointer{ obj->GetObjectByName(HANDLEFT) };
-		hand_right = RE::NiPointer{ obj->GetObjectByName(HANDRIGHT) };
-		foot_left = RE::NiPointer{ obj->GetObjectByName(FOOTLEFT) };
-		foot_rigt = RE::NiPointer{ obj->GetObjectByName(FOOTRIGHT) };
+		hand_left = RE::NiPointer{ nodes[NodeFrame::HandLeft] };
+		hand_right = RE::NiPointer{ nodes[NodeFrame::HandRight] };
+		foot_left = RE::NiPointer{ nodes[NodeFrame::FootLeft] };
+		foot_rigt = RE::NiPointer{ nodes[NodeFrame::FootRight] };
 		if (!hand_left || !hand_right || !foot_left || !foot_rigt) {
 			logger::info("Actor {:X} is missing limb nodes (This may be expected for creature actors)", a_actor->formID);
 		}
-		clitoris = RE::NiPointer{ obj->GetObjectByName(CLITORIS) };
-		const auto findschlong = [&]<typename T>(const T& a_list) -> RE::NiAVObject* {
-			for (auto&& it : a_list) {
-				if (const auto ret = obj->GetObjectByName(it))
-					return ret;
-			}
-			return nullptr;
-		};
-		if (a_alternatenodes) {
-			sos_base = RE::NiPointer{ findschlong(SOSSTART_ALT) };
-			sos_mid = RE::NiPointer{ findschlong(SOSMID_ALT) };
-			sos_front = RE::NiPointer{ findschlong(SOSTIP_ALT) };
-		} else {
-			sos_base = RE::NiPointer{ findschlong(SOSSTART) };
-			sos_mid = RE::NiPointer{ findschlong(SOSMID) };
-			sos_front = RE::NiPointer{ findschlong(SOSTIP) };
-		}
-	}
-
-	RE::NiPoint3 Physics::Position::Nodes::ApproximateNode(float a_forward, float a_upward) const
-	{
-		Registry::Coordinate approx(std::vector{ a_forward, 0.0f, a_upward, 0.0f });
-		RE::NiPoint3 angle;
-		pelvis->world.rotate.ToEulerAnglesXYZ(angle);
-		Registry::Coordinate ret{ pelvis->world.translate, angle.z };
-		approx.Apply(ret);
-		return ret.AsNiPoint();
-	}
-
-	RE::NiPoint3 Physics::Position::Nodes::ApproximateTip() const
-	{
-		constexpr float forward = 20.0f;
-		constexpr float upward = -4.0f;
-		return ApproximateNode(forward, upward);
-	}
-
-	RE::NiPoint3 Physics::Position::Nodes::ApproximateMid() const
-	{
-		constexpr float forward = 15.0f;
-		constexpr float upward = -6.2f;
-		return ApproximateNode(forward, upward);
+		clitoris = RE::NiPointer{ nodes[NodeFrame::Clitoris] };
+		sos_base = RE::NiPointer{ nodes[NodeFrame::SosBase] };
+		sos_mid = RE::NiPointer{ nodes[NodeFrame::SosMid] };
+		sos_front = RE::NiPointer{ nodes[NodeFrame::SosFront] };
 	}
 
-	RE::NiPoint3 Physics::Position::Nodes::ApproximateBase() const
+	Physics::NodeFrame Physics::Position::Nodes::Capture() const
 	{
-		constexpr float forward = 10.0f;
-		constexpr float upward = -5.0f;
-		return ApproximateNode(forward, upward);
-	}
-
-	Physics::Position::Position(RE::Actor* a_owner, Sex a_sex) :
-		_owner(a_owner->GetFormID()), _sex(a_sex), _nodes(a_owner, false), _types({}) {}
-
-	Physics::TypeData* Physics::Position::GetType(TypeData& a_data){
-		auto where = std::ranges::find_if(_types, [&](auto& type) {
-			return a_data._type == type._type && a_data._partner == type._partner;
-		});
-		if (where == _types.end()) {
-			return nullptr;
-		}
-		return &(*where);
-	}
-
-	Physics::PhysicsData::WorkingData::WorkingData(Position& a_position) :
-		_position(a_position),
-		pGenitalReference([&]() {
-			if (this->vSchlong == RE::NiPoint3::Zero()) {
-				if (this->_position._nodes.clitoris)
-					return this->_position._nodes.clitoris->world.translate;
-			} else {
-				return this->_position._nodes.sos_mid ?
-								 this->_position._nodes.sos_mid->world.translate :
-								 this->_position._nodes.ApproximateMid();
-			}
-			return RE::NiPoint3::Zero();
-		}()),
-		vCrotch(a_position._nodes.pelvis->world.translate - a_position._nodes.spine_lower->world.translate),
-		vSchlong([&]() {
-			const auto& nodes = a_position._nodes;
-			if (!nodes.sos_mid) {
-				if (a_position._sex.any(Sex::Male, Sex::Futa)) {
-					const auto mid = a_position._nodes.ApproximateMid();
-					const auto base = a_position._nodes.ApproximateBase();
-					return mid - base;
+		NodeFrame ret{};
+		const auto capture = [&](NodeFrame::NodeID a_node, const RE::NiPointer<RE::NiAVObject>& a_obj) {
+			if (!a_obj)
+				return;
+			const auto& world = a_obj->world;
+			Interaction::Transform transform{};
+			for (glm::length_t r = 0; r < 3; r++) {
+				for (glm::length_t c = 0; c < 3; c++) {
+					transform.rotate[c][r] = world.rotate.entry[r][c];
 				}
-				return RE::NiPoint3::Zero();
 			}
-			if (nodes.sos_base) {
-				return nodes.sos_mid->world.translate - nodes.sos_base->world.translate;
-			} else if (nodes.sos_front) {
-				return nodes.sos_front->world.translate - nodes.sos_mid->world.translate;
-			}
-			return RE::NiPoint3::Zero();
-		}())
-	{
-		vCrotch.Unitize();
-		vSchlong.Unitize();
-	}
-
-	std::optional<Physics::TypeData> Physics::PhysicsData::WorkingData::GetsOral(const WorkingData& a_partner) const
-	{
-		if (!a_partner._position._nodes.head)
-			return std::nullopt;
-		const auto& headworld = a_partner._position._nodes.head->world;
-		if (pGenitalReference == RE::NiPoint3::Zero())
-			return std::nullopt;
-		auto distance = pGenitalReference.GetDistance(headworld.translate);
-		if (distance > Settings::fDistanceHead)
-			return std::nullopt;
-		if (vSchlong != RE::NiPoint3::Zero()) {
-			const auto vRot = headworld.rotate * vSchlong;
-			const auto dot = vRot.Dot(vSchlong);
-			const auto angle = RE::rad_to_deg(std::acosf(dot));
-			if (angle > Settings::fAngleMouth || angle < (180 - Settings::fAngleMouth)) {
-				return std::nullopt;
-			}
-		}
-		TypeData ret{};
-		ret._distance = distance;
-		ret._partner = a_partner._position._owner;
-		ret._type = TypeData::Type::Oral;
-		return ret;
-	}
-
-	std::optional<Physics::TypeData> Physics::PhysicsData::WorkingData::GetsHandjob(const WorkingData& a_partner) const
-	{
-		const auto& handL = a_partner._position._nodes.hand_left;
-		const auto& handR = a_partner._position._nodes.hand_right;
-		if (pGenitalReference == RE::NiPoint3::Zero())
-			return std::nullopt;
-		const auto make = [&](decltype(handL)& hand) -> std::optional<TypeData> {
-			if (!hand)
-				return std::nullopt;
-			const auto d = hand->world.translate.GetDistance(pGenitalReference);
-			if (d > Settings::fDistanceHand)
-				return std::nullopt;
-			TypeData ret{};
-			ret._distance = d;
-			ret._partner = a_partner._position._owner;
-			ret._type = TypeData::Type::Hand;
-			return ret;
+			transform.translate = { world.translate.x, world.translate.y, world.translate.z };
+			ret.Set(a_node, transform);
 		};
-		if (auto ret = make(handL))
-			return ret;
-		if (auto ret = make(handR))
-			return ret;
-		return std::nullopt;
+		capture(NodeFrame::Head, head);
+		capture(NodeFrame::Pelvis, pelvis);
+		capture(NodeFrame::SpineLower, spine_lower);
+		capture(NodeFrame::HandLeft, hand_left);
+		capture(NodeFrame::HandRight, hand_right);
+		capture(NodeFrame::FootLeft, foot_left);
+		capture(NodeFrame::FootRight, foot_rigt);
+		capture(NodeFrame::Clitoris, clitoris);
+		capture(NodeFrame::SosBase, sos_base);
+		capture(NodeFrame::SosMid, sos_mid);
+		capture(NodeFrame::SosFront, sos_front);
+		return ret;
 	}
 
-	std::optional<Physics::TypeData> Physics::PhysicsData::WorkingData::GetsFootjob(const WorkingData& a_partner) const
-	{
-		const auto& footL = a_partner._position._nodes.foot_left;
-		const auto& footR = a_partner._position._nodes.foot_rigt;
-		if (pGenitalReference == RE::NiPoint3::Zero())
-			return std::nullopt;
-		const auto make = [&](decltype(footL)& foot) -> std::optional<TypeData> {
-			if (!foot)
-				return std::nullopt;
-			const auto d = foot->world.translate.GetDistance(pGenitalReference);
-			if (d > Settings::fDistanceFoot)
-				return std::nullopt;
-			TypeData ret{};
-			ret._distance = d;
-			ret._partner = a_partner._position._owner;
-			ret._type = TypeData::Type::Foot;
-			return ret;
-		};
-		if (auto ret = make(footL))
-			return ret;
-		if (auto ret = make(footR))
-			return ret;
-		return std::nullopt;
-	}
+	Physics::Position::Position(RE::Actor* a_owner, Sex a_sex) :
+		_owner(a_owner->GetFormID()), _sex(a_sex), _nodes(a_owner, false), _types({}) {}
 
-	std::optional<Physics::TypeData> Physics::PhysicsData::WorkingData::DoesGrinidng(const WorkingData& a_partner) const
+	Physics::PhysicsData::Record::Record(const fs::path& a_file, const std::vector<Position>& a_positions, std::chrono::milliseconds a_interval)
 	{
-		const auto& cT = _position._nodes.clitoris;
-		if (!cT)
-			return std::nullopt;
-		float d;
-		if (a_partner.vSchlong != RE::NiPoint3::Zero()) {
-			const auto& dot = vCrotch.Dot(a_partner.vSchlong);
-			const auto deg = RE::rad_to_deg(std::acosf(dot));
-			if (deg < (180 - Settings::fAngleGrinding) || deg > Settings::fAngleGrinding) {
-				return std::nullopt;
-			}
-			const auto& sPtr = a_partner._position._nodes.sos_mid;
-			const auto refP = sPtr ? sPtr->world.translate : a_partner._position._nodes.ApproximateMid();
-			d = cT->world.translate.GetDistance(refP);
-		} else {
-			const auto& cPtr = a_partner._position._nodes.clitoris;
-			if (!cPtr)
-				return std::nullopt;
-			d = cT->world.translate.GetDistance(cPtr->world.translate);
+		std::error_code ec{};
+		fs::create_directories(a_file.parent_path(), ec);
+		_stream.open(a_file, std::ios::binary | std::ios::trunc);
+		if (!_stream.is_open()) {
+			logger::error("Unable to create physics record {}", a_file.string());
+			return;
 		}
-		if (d > Settings::fDistanceCrotch / 2)
-			return std::nullopt;
-		TypeData ret{};
-		ret._distance = d;
-		ret._partner = a_partner._position._owner;
-		ret._type = TypeData::Type::Grinding;
-		return ret;
+		Interaction::Record::Header header{ static_cast<uint32_t>(a_interval.count()), {} };
+		for (auto&& position : a_positions) {
+			header.owners.push_back({ position._owner, position._sex.underlying() });
+		}
+		Interaction::Record::WriteHeader(_stream, header);
+		logger::info("Recording physics to {}", a_file.string());
 	}
 
-	std::optional<Physics::TypeData> Physics::PhysicsData::WorkingData::HasIntercourse(const WorkingData& a_partner) const
+	void Physics::PhysicsData::Record::Write(const std::vector<NodeFrame>& a_frames, float a_timestamp)
 	{
-		if (a_partner.vSchlong == RE::NiPoint3::Zero()) {
-			return std::nullopt;
-		}
-		const auto dot = vCrotch.Dot(a_partner.vSchlong);
-		const auto deg = RE::rad_to_deg(std::acosf(dot));
-		if (deg < (90 - Settings::fAnglePenetration) || deg > (90 + Settings::fAnglePenetration)) {
-			return std::nullopt;
-		}
-		assert(_position._nodes.pelvis && _position._nodes.spine_lower);
-		const auto& refTA = _position._nodes.spine_lower->world.translate;
-		const auto& refP = a_partner._position._nodes.sos_mid ?
-												 a_partner._position._nodes.sos_mid->world.translate :
-												 a_partner._position._nodes.ApproximateMid();
-		const auto dA = refTA.GetDistance(refP);
-		if (dA > Settings::fDistanceCrotch) {
-			return std::nullopt;
-		}
-		TypeData ret{};
-		ret._partner = a_partner._position._owner;
-		if (_position._sex != Sex::Male) {
-			const auto& refTV = _position._nodes.pelvis->world.translate;
-			const auto dV = refTV.GetDistance(refP);
-			if (dV < Settings::fDistanceCrotch) {
-				ret._distance = dV < dA ? dV : dA;
-				ret._type = dV < dA ? TypeData::Type::VaginalP : TypeData::Type::AnalP;
-				return ret;
-			}
-		}
-		ret._distance = dA;
-		ret._type = TypeData::Type::AnalP;
-		return ret;
+		if (!_stream.is_open())
+			return;
+		Interaction::Record::WriteTick(_stream, a_frames, a_timestamp);
 	}
 
 	Physics::PhysicsData::PhysicsData(std::vector<RE::Actor*> a_positions, const Scene* a_scene) :
@@ -277,62 +139,108 @@ namespace Registry
 			}
 			return v;
 		}()),
+		_record([&]() -> std::unique_ptr<Record> {
+			if (!Settings::bRecordPhysics)
+				return nullptr;
+			const auto file = fs::path{ RECORD_PATH } / fmt::format("{}_{}.slpr", a_scene->id, std::time(nullptr));
+			return std::make_unique<Record>(file, _positions, std::chrono::milliseconds(Settings::iPhysicsIntervalMin));
+		}()),
+		_history(_positions.size()),
+		_frames(_positions.size()),
+		_lastframes(_positions.size()),
+		_bodies([&]() {
+			std::vector<Interaction::Body> v{};
+			v.reserve(_positions.size());
+			for (auto&& position : _positions) {
+				v.emplace_back(position._owner, position._sex.underlying());
+			}
+			return v;
+		}()),
+		_interval(std::max(Settings::iPhysicsIntervalMin, 1)),
 		_tactive(true), _t(&Physics::PhysicsData::Update, this) {}
 
 	Physics::PhysicsData::~PhysicsData()
 	{
 		_tactive = false;
 		_t.join();
+		logger::info("Physics ran {} ticks, final interval {}ms; broad phase skipped {}/{} pairs", _ticks.load(), _interval.load(), _skipped, _pairs);
+	}
+
+	std::chrono::milliseconds Physics::PhysicsData::NextInterval(std::chrono::milliseconds a_current, std::chrono::milliseconds a_elapsed,
+		const std::vector<NodeFrame>& a_previous, const std::vector<Interaction::Body>& a_bodies)
+	{
+		const auto floor = std::chrono::milliseconds(std::max(Settings::iPhysicsIntervalMin, 1));
+		const auto ceiling = std::max(floor, std::chrono::milliseconds(Settings::iPhysicsIntervalMax));
+		float speed = 0.0f;	 // units per ms
+		for (auto&& data : a_bodies) {
+			if (data.types.size() != data._previous->size())
+				return floor;
+			for (auto&& type : data.types) {
+				if (!data.GetPrevious(type))
+					return floor;
+				speed = std::max(speed, std::abs(type._velocity));
+			}
+		}
+		const auto ms = static_cast<float>(std::max<int64_t>(a_elapsed.count(), 1));
+		for (size_t i = 0; i < a_bodies.size() && i < a_previous.size(); i++) {
+			const auto& current = *a_bodies[i]._frame;
+			for (size_t n = 0; n < NodeFrame::Total; n++) {
+				const auto node = NodeFrame::NodeID(n);
+				if (!current.Has(node) || !a_previous[i].Has(node))
+					continue;
+				speed = std::max(speed, glm::distance(current.GetTranslate(node), a_previous[i].GetTranslate(node)) / ms);
+			}
+		}
+		// Raise the rate right away, but only lower it gradually so a short pause does not drop to the ceiling
+		const auto target = speed > 0.0f ? Settings::fPhysicsMaxStep / speed : static_cast<float>(ceiling.count());
+		const auto next = std::min(target, a_current.count() * 1.5f);
+		return std::clamp(std::chrono::milliseconds(static_cast<int64_t>(next)), floor, ceiling);
+	}
+
+	float Physics::PhysicsData::GetActiveFraction(RE::FormID a_position, RE::FormID a_partner, int32_t a_type, float a_window) const
+	{
+		const auto position = std::ranges::find(_positions, a_position, [](auto& it) { return it._owner; });
+		const auto partner = std::ranges::find(_positions, a_partner, [](auto& it) { return it._owner; });
+		if (position == _positions.end() || partner == _positions.end() || a_type < 0 || a_type >= static_cast<int32_t>(Interaction::History::TYPES))
+			return -1.0f;
+		return _history.GetActiveFraction(std::distance(_positions.begin(), position), std::distance(_positions.begin(), partner), TypeData::Type(a_type), a_window);
 	}
 
 	void Physics::PhysicsData::Update()
 	{
-		constexpr auto interval = 128ms;
 		const auto main = RE::Main::GetSingleton();
+		const auto start = std::chrono::steady_clock::now();
+		auto last = start;
+		auto interval = GetInterval();
 		while (_tactive) {
 			if (!main->gameActive) {
-				std::this_thread::sleep_for(interval * 2);
+				std::this_thread::sleep_for(std::chrono::milliseconds(std::max(Settings::iPhysicsIntervalMax, 1)));
+				last = std::chrono::steady_clock::now();
 				continue;
 			}
-			const auto update = [&interval](WorkingData& data, std::optional<TypeData> a_type) {
-				if (!a_type)
-					return a_type;
-				auto stored = data._position.GetType(*a_type);
-				if (stored) {
-					const float delta_dist = a_type->_distance - stored->_distance;
-					a_type->_velocity = (stored->_velocity + (delta_dist / interval.count())) / 2;
-				} else {
-					a_type->_velocity = 0.0f;
-				}
-				data.types.push_back(*a_type);
-				return a_type;
-			};
-			std::vector<std::shared_ptr<WorkingData>> snapshots{};
-			snapshots.reserve(_positions.size());
-			for (auto&& it : _positions) {
-				auto& obj = snapshots.emplace_back(std::make_shared<WorkingData>(it));
-				update(*obj, obj->GetsHandjob(*obj));
+			const auto now = std::chrono::steady_clock::now();
+			const auto elapsed = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(now - last), std::chrono::milliseconds(1));
+			last = now;
+			for (size_t i = 0; i < _positions.size(); i++) {
+				_frames[i] = _positions[i]._nodes.Capture();
+				_bodies[i].Prepare(_frames[i], _positions[i]._types);
 			}
-			assert(_positions.size() == snapshots.size());
-			Combinatorics::for_each_permutation(snapshots.begin(), snapshots.begin() + 2, snapshots.end(), 
-				[&](auto start, [[maybe_unused]] auto end) {
-					assert(std::distance(start, end) == 2);
-					auto& fst = **start;
-					auto& snd = **(start + 1);
-					update(fst, fst.GetsOral(snd));
-					update(fst, fst.GetsHandjob(snd));
-					update(fst, fst.GetsFootjob(snd));
-					update(fst, fst.DoesGrinidng(snd));
-					if (auto type = update(fst, fst.HasIntercourse(snd))) {
-						TypeData mirror = *type;
-						mirror._type = type->_type == TypeData::Type::VaginalP ? TypeData::Type::VaginalA : TypeData::Type::AnalA;
-						snd.types.push_back(mirror);
-					}
-					return false;
-			});
+			const auto n = _bodies.size();
+			_pairs += n * (n - 1);
+			_skipped += Interaction::Evaluate(_bodies, GetThresholds(), Settings::bPhysicsBroadPhase);
+			std::chrono::duration<float, std::milli> timestamp = now - start;
+			if (_record) {
+				_record->Write(_frames, timestamp.count());
+			}
+			_history.Update(_bodies, timestamp.count(), GetHysteresis(Settings::iPhysicsEnterTicks), GetHysteresis(Settings::iPhysicsExitTicks));
+			interval = NextInterval(interval, elapsed, _lastframes, _bodies);
+			_interval = static_cast<uint32_t>(interval.count());
+			_ticks++;
+			// Swap instead of move so every buffer keeps its storage for the next tick
 			for (size_t i = 0; i < _positions.size(); i++) {
-				_positions[i]._types = std::move(snapshots[i]->types);
+				_positions[i]._types.swap(_bodies[i].types);
 			}
+			_frames.swap(_lastframes);
 			std::this_thread::sleep_for(interval);
 		}
 	}
@@ -372,4 +280,26 @@ namespace Registry
 		return where == _data.end() ? nullptr : where->second.get();
 	}
 
+	int32_t Physics::Replay(const fs::path& a_file, bool a_makegolden) noexcept
+	{
+		const auto path = a_file.is_relative() ? fs::path{ RECORD_PATH } / a_file : a_file;
+		try {
+			Interaction::Record::ReplayParams params{
+				.limits = GetThresholds(),
+				.broadphase = Settings::bPhysicsBroadPhase,
+				.enter = GetHysteresis(Settings::iPhysicsEnterTicks),
+				.exit = GetHysteresis(Settings::iPhysicsExitTicks),
+			};
+			const auto summary = Interaction::Record::Replay(path, a_makegolden, params);
+			if (summary.truncated) {
+				logger::warn("Record {} is truncated after {} ticks", path.filename().string(), summary.ticks);
+			}
+			logger::info("{}: {}", path.filename().string(), summary.ToString());
+			return summary.mismatches;
+		} catch (const std::exception& e) {
+			logger::error("Unable to replay physics record {}, Error: {}", path.string(), e.what());
+			return -1;
+		}
+	}
+
 }	 // namespace Registry
@@ -2,70 +2,17 @@
 
 #include "Registry/Define/Sex.h"
 #include "Registry/Animation.h"
+#include "Registry/Util/Interaction.h"
 
 namespace Registry
 {
-	static constexpr std::string_view HEAD{ "NPC Head [Head]"sv };				 // Back of throat
-	static constexpr std::string_view PELVIS{ "NPC Pelvis [Pelv]"sv };		 // bottom mid (front)
-	static constexpr std::string_view SPINELOWER{ "NPC Spine [Spn0]"sv };	 // bottom mid (back)
-
-	static constexpr std::string_view HANDLEFT{ "NPC L Finger20 [LF20]"sv };	// Base of middle finger
-	static constexpr std::string_view HANDRIGHT{ "NPC R Finger20 [RF20]"sv };
-	static constexpr std::string_view FOOTLEFT{ "NPC L Foot [Lft ]"sv };	// Ankle
-	static constexpr std::string_view FOOTRIGHT{ "NPC R Foot [Rft ]"sv };
-
-	static constexpr std::string_view CLITORIS{ "Clitoral1"sv };
-	static constexpr std::string_view VAGINA{ "VaginaDeep1"sv };
-	static constexpr std::string_view VAGINALLEFT{ "NPC L Pussy02"sv };
-	static constexpr std::string_view VAGINALRIGHT{ "NPC R Pussy02"sv };
-	static constexpr std::string_view ANAL{ "NPC Anus Deep2"sv };
-	static constexpr std::string_view ANALLEFT{ "NPC LB Anus2"sv };
-	static constexpr std::string_view ANALRIGHT{ "NPC RB Anus2"sv };
-	static constexpr std::array SOSSTART{
-		"NPC Genitals01 [Gen01]"sv, "AH Base"sv, "DD 2"sv, "DD2"sv, "NPC IceGenital02"sv, "BearD 3"sv, "GS 3"sv, "BoarDick01"sv, "RD 2"sv, "CDPenis 2"sv, "CO 2"sv,
-		"ElkD03"sv, "DwarvenSpiderDildo01"sv, "FD 3"sv, "GD 3"sv, "Goat_Penis02"sv, "Horker_Penis04"sv, "HS 3"sv, "SCD 3"sv, "SkeeverD 03"sv, "TD 3"sv, "VLDick03"sv,
-		"WWD 4"sv, "Torso Rock 2a"sv
-	};
-	static constexpr std::array SOSMID{
-		"NPC Genitals04 [Gen04]"sv, "AH 3"sv, "DD 3"sv, "DD3"sv, "NPC IceGenital03"sv, "BearD 6"sv, "GS 4"sv, "BoarDick03"sv, "RD 3"sv, "CDPenis 5"sv, "CO 5"sv,
-		"ElkD04"sv, "DwarvenSpiderDildo02"sv, "FD 4"sv, "GD 4"sv, "Goat_Penis04"sv, "Horker_Penis06"sv, "HS 6"sv, "SCD 4"sv, "SkeeverD 05"sv, "TD 5"sv, "VLDick05"sv,
-		"WWD 7"sv, "Torso Rock 2"sv
-	};
-	static constexpr std::array SOSTIP{
-		"NPC Genitals06 [Gen06]"sv, "AH 6"sv, "DD 6"sv, "DD6"sv, "BearD 8"sv, "GS 7"sv, "BoarDick06"sv, "RD 5"sv, "CDPenis 7"sv, "CO 9"sv, "ElkD06"sv, "DwarvenSpiderDildo03"sv,
-		"FD 7"sv, "GD 7"sv, "Goat_Penis06"sv, "Horker_Penis10"sv, "HS 7"sv, "SCD 7"sv, "SkeeverD 07"sv, "TD 7"sv, "VLDick06"sv, "WWD 9"sv
-	};
-	// Actors with more than 1 schlong
-	static constexpr std::array SOSSTART_ALT{ "RD 2"sv };
-	static constexpr std::array SOSMID_ALT{ "RD 3"sv };
-	static constexpr std::array SOSTIP_ALT{ "RD 5"sv };
-
 	class Physics :
 		public Singleton<Physics>
 	{
-		struct TypeData
-		{
-			enum class Type
-			{
-				None = -1,
-				VaginalP = 0,	 // being penetrated (passive)
-				AnalP = 1,
-				VaginalA = 2,	 // penetrating (active)
-				AnalA = 3,
-				Oral = 4,
-				Foot = 5,
-				Hand = 6,
-				Grinding = 7,
-
-				Total,
-			};
-
-			RE::FormID _partner{ 0 };	 // actor performing type
-			Type _type{ Type::None };	 // action type performed by partner
+		static inline const auto RECORD_PATH{ CONFIGPATH("Physics") };
 
-			float _velocity{ 0.0f };
-			float _distance{ 0.0f };
-		};
+		using TypeData = Interaction::TypeData;
+		using NodeFrame = Interaction::NodeFrame;
 
 		struct Position
 		{
@@ -74,6 +21,8 @@ namespace Registry
 				Nodes(const RE::Actor* a_actor, bool a_alternatenodes);
 				~Nodes() = default;
 
+				NodeFrame Capture() const;
+
 				RE::NiPointer<RE::NiAVObject> head;
 				RE::NiPointer<RE::NiAVObject> pelvis;
 				RE::NiPointer<RE::NiAVObject> spine_lower;
@@ -87,22 +36,12 @@ namespace Registry
 				RE::NiPointer<RE::NiAVObject> sos_base;
 				RE::NiPointer<RE::NiAVObject> sos_mid;
 				RE::NiPointer<RE::NiAVObject> sos_front;
-
-			public:
-				RE::NiPoint3 ApproximateTip() const;
-				RE::NiPoint3 ApproximateMid() const;
-				RE::NiPoint3 ApproximateBase() const;
-
-			private:
-				RE::NiPoint3 ApproximateNode(float a_forward, float a_upward) const;
 			};
 
 		public:
 			Position(RE::Actor* a_owner, Sex a_sex);
 			~Position() = default;
 
-			Physics::TypeData* GetType(TypeData& a_data);
-
 		public:
 			RE::FormID _owner;
 			stl::enumeration<Sex> _sex;
@@ -112,35 +51,55 @@ namespace Registry
 
 		class PhysicsData
 		{
-			struct WorkingData
+		public:
+			/// Writes every tick's node frames to a file, see Interaction::Record for the layout
+			class Record
 			{
-				WorkingData(Position& a_position);
-				~WorkingData() = default;
+			public:
+				Record(const fs::path& a_file, const std::vector<Position>& a_positions, std::chrono::milliseconds a_interval);
+				~Record() = default;
 
-				std::optional<TypeData> GetsOral(const WorkingData& a_partner) const;				 // a_partner giving oral to this
-				std::optional<TypeData> GetsHandjob(const WorkingData& a_partner) const;		 // a_partner pleasuring this with hands
-				std::optional<TypeData> GetsFootjob(const WorkingData& a_partner) const;		 //  --- "" --- feet
-				std::optional<TypeData> DoesGrinidng(const WorkingData& a_partner) const;		 // a_partner penetrating this
-				std::optional<TypeData> HasIntercourse(const WorkingData& a_partner) const;	 // a_partner penetrating this
+				void Write(const std::vector<NodeFrame>& a_frames, float a_timestamp);
 
-			public:
-				Position& _position;
-				std::vector<TypeData> types{};
-				RE::NiPoint3 pGenitalReference{};
-				RE::NiPoint3 vCrotch{};
-				RE::NiPoint3 vSchlong{};
+			private:
+				std::ofstream _stream;
 			};
 
 		public:
 			PhysicsData(std::vector<RE::Actor*> a_positions, const Scene* a_scene);
 			~PhysicsData();
 
+			/// @brief Pick the time until the next tick, based on how much the scene changed during the last one
+			/// Reported interactions changing resets the interval to its floor, otherwise it follows the fastest moving node or interaction
+			/// @param a_current The interval used for the last tick
+			/// @param a_elapsed The time actually passed since the previous tick
+			/// @param a_previous The node frames of the previous tick
+			/// @param a_bodies The bodies of this tick, after their interactions have been debounced
+			static std::chrono::milliseconds NextInterval(std::chrono::milliseconds a_current, std::chrono::milliseconds a_elapsed,
+				const std::vector<NodeFrame>& a_previous, const std::vector<Interaction::Body>& a_bodies);
+
+			std::chrono::milliseconds GetInterval() const { return std::chrono::milliseconds(_interval.load()); }
+			float GetTickRate() const { return 1000.0f / std::max<uint32_t>(_interval.load(), 1); }
+			/// @brief Get the fraction of the last a_window ms in which a_partner was interacting with a_position in the given way
+			/// @return The fraction in [0, 1], or a negative value if either actor is not part of this scene
+			_NODISCARD float GetActiveFraction(RE::FormID a_position, RE::FormID a_partner, int32_t a_type, float a_window) const;
+
 		public:
 			std::vector<Position> _positions;
 
 		private:
 			void Update();
 
+			std::unique_ptr<Record> _record;
+			Interaction::History _history;
+			// Per tick working storage, allocated once per scene
+			std::vector<NodeFrame> _frames;
+			std::vector<NodeFrame> _lastframes;
+			std::vector<Interaction::Body> _bodies;
+			std::atomic<uint32_t> _interval;	// effective time between ticks, in ms
+			std::atomic<uint32_t> _ticks{ 0 };
+			size_t _pairs{ 0 };
+			size_t _skipped{ 0 };
 			std::atomic<bool> _tactive;
 			std::thread _t;
 		};
@@ -151,6 +110,12 @@ namespace Registry
 		bool IsRegistered(RE::FormID a_id) const noexcept;
 		const PhysicsData* GetData(RE::FormID a_id) const;
 
+		/// @brief Feed a recorded scene through the interaction tests and write a report next to it, see Interaction::Record::Replay
+		/// @param a_file The record file to replay, relative paths are looked up in the record directory
+		/// @param a_makegolden If the produced interactions should be stored as the golden output of this record
+		/// @return The number of ticks which differ from the golden output, or -1 if the record could not be replayed
+		static int32_t Replay(const fs::path& a_file, bool a_makegolden) noexcept;
+
 	private:
 		std::vector<std::pair<RE::FormID, std::unique_ptr<PhysicsData>>> _data;
 	};
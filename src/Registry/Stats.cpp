@@ -66,30 +66,41 @@ namespace Registry::Statistics
 		}
 	}
 
-	ActorStats::ActorStats(SKSE::SerializationInterface* a_intfc) :
-		_stats(StatisticID::Total), _custom({})
-	{
-		for (size_t i = 0; i < StatisticID::Total; i++) {
-			a_intfc->ReadRecordData(_stats[i]);
-		}
-		size_t numRegs;
-		a_intfc->ReadRecordData(numRegs);
-
-		std::string key;
-		size_t alternative;
-		for (size_t i = 0; i < numRegs; i++) {
-			stl::read_string(a_intfc, key);
-			a_intfc->ReadRecordData(alternative);
-			if (alternative == 0) {
-				float obj;
-				a_intfc->ReadRecordData(obj);
-				_custom[key] = obj;
-			} else {
-				std::string obj;
-				stl::read_string(a_intfc, obj);
-				_custom[key] = obj;
-			}
+	CustomKeys::KeyID CustomKeys::Intern(const RE::BSFixedString& a_name)
+	{
+		{
+			const std::shared_lock lock{ _m };
+			const auto where = _ids.find(a_name.data());
+			if (where != _ids.end())
+				return where->second;
 		}
+		const std::unique_lock lock{ _m };
+		const auto [where, inserted] = _ids.emplace(a_name.data(), static_cast<KeyID>(_names.size()));
+		if (inserted) {
+			if (_names.size() >= INVALID_KEY)
+				throw std::exception("Too many custom statistics");
+			_names.push_back(a_name);
+		}
+		return where->second;
+	}
+
+	CustomKeys::KeyID CustomKeys::Find(const RE::BSFixedString& a_name) const
+	{
+		const std::shared_lock lock{ _m };
+		const auto where = _ids.find(a_name.data());
+		return where == _ids.end() ? INVALID_KEY : where->second;
+	}
+
+	RE::BSFixedString CustomKeys::GetName(KeyID a_id) const
+	{
+		const std::shared_lock lock{ _m };
+		return a_id < _names.size() ? _names[a_id] : RE::BSFixedString{};
+	}
+
+	size_t CustomKeys::Size() const
+	{
+		const std::shared_lock lock{ _m };
+		return _names.size();
 	}
 
 	void ActorStats::SetStatistic(StatisticID key, float value)
@@ -109,117 +120,124 @@ namespace Registry::Statistics
 
 	std::vector<RE::BSFixedString> ActorStats::GetEveryCustomID() const
 	{
-		const auto v = std::views::keys(_custom);
-		return std::vector<RE::BSFixedString>{ v.begin(), v.end() };
+		const auto keys = CustomKeys::GetSingleton();
+		std::vector<RE::BSFixedString> ret{};
+		ret.reserve(_custom.size());
+		for (auto&& [key, _] : _custom) {
+			ret.push_back(keys->GetName(key));
+		}
+		return ret;
 	}
 
-	std::optional<float> ActorStats::GetCustomFlt(const RE::BSFixedString& key) const
+	const ActorStats::CustomValue* ActorStats::FindCustom(KeyID key) const
+	{
+		const auto where = std::ranges::lower_bound(_custom, key, {}, &std::pair<KeyID, CustomValue>::first);
+		return where != _custom.end() && where->first == key ? &where->second : nullptr;
+	}
+
+	void ActorStats::SetCustom(KeyID key, CustomValue&& value)
+	{
+		const auto where = std::ranges::lower_bound(_custom, key, {}, &std::pair<KeyID, CustomValue>::first);
+		if (where != _custom.end() && where->first == key) {
+			where->second = std::move(value);
+		} else {
+			_custom.emplace(where, key, std::move(value));
+		}
+	}
+
+	bool ActorStats::HasCustom(KeyID key) const
+	{
+		return FindCustom(key) != nullptr;
+	}
+
+	std::optional<float> ActorStats::GetCustomFlt(KeyID key) const
 	{
 		return GetCustom<float>(key);
 	}
 
-	std::optional<RE::BSFixedString> ActorStats::GetCustomStr(const RE::BSFixedString& key) const
+	std::optional<RE::BSFixedString> ActorStats::GetCustomStr(KeyID key) const
 	{
 		return GetCustom<RE::BSFixedString>(key);
 	}
 
-	void ActorStats::SetCustomFlt(const RE::BSFixedString& key, float value)
+	void ActorStats::SetCustomFlt(KeyID key, float value)
 	{
-		_custom[key] = value;
+		SetCustom(key, value);
 	}
 
-	void ActorStats::SetCustomStr(const RE::BSFixedString& key, RE::BSFixedString value)
+	void ActorStats::SetCustomStr(KeyID key, RE::BSFixedString value)
+	{
+		SetCustom(key, std::move(value));
+	}
+
+	void ActorStats::RemoveCustomStat(KeyID key)
 	{
-		_custom[key] = value;
+		const auto where = std::ranges::lower_bound(_custom, key, {}, &std::pair<KeyID, CustomValue>::first);
+		if (where != _custom.end() && where->first == key)
+			_custom.erase(where);
 	}
 
 	bool ActorStats::HasCustom(const RE::BSFixedString& key) const
 	{
-		return _custom.contains(key);
+		return HasCustom(CustomKeys::GetSingleton()->Find(key));
 	}
 
-	void ActorStats::RemoveCustomStat(const RE::BSFixedString& key)
+	std::optional<float> ActorStats::GetCustomFlt(const RE::BSFixedString& key) const
 	{
-		_custom.erase(key);
+		return GetCustomFlt(CustomKeys::GetSingleton()->Find(key));
 	}
 
-	void ActorStats::Save(SKSE::SerializationInterface* a_intfc)
+	std::optional<RE::BSFixedString> ActorStats::GetCustomStr(const RE::BSFixedString& key) const
 	{
-		for (auto&& stat : _stats) {
-			if (!a_intfc->WriteRecordData(stat)) {
-				logger::error("Failed to save statistic");
-				continue;
-			}
-		}
-		if (!a_intfc->WriteRecordData(_custom.size())) {
-			logger::error("Failed to save number of custom statistics ({})", _custom.size());
-			return;
-		}
-		for (auto&& [id, stat] : _custom) {
-			if (!stl::write_string(a_intfc, id)) {
-				logger::error("Failed to save custom statistic {}", id);
-				continue;
-			}
-			if (std::holds_alternative<float>(stat)) {
-				a_intfc->WriteRecordData(0);
-				if (!a_intfc->WriteRecordData(stat)) {
-					logger::error("Failed to save custom statistic {}", id);
-					continue;
-				}
-			} else {
-				a_intfc->WriteRecordData(1);
-				auto save = std::get<RE::BSFixedString>(stat);
-				if (!stl::write_string(a_intfc, save)) {
-					logger::error("Failed to save custom statistic {}", id);
-					continue;
-				}
-			}
-		}
+		return GetCustomStr(CustomKeys::GetSingleton()->Find(key));
 	}
 
-	ActorEncounter::EncounterObj::EncounterObj(RE::Actor* obj) :
-		id(obj->GetFormID()), sex(Registry::GetSex(obj)) {}
+	void ActorStats::SetCustomFlt(const RE::BSFixedString& key, float value)
+	{
+		SetCustomFlt(CustomKeys::GetSingleton()->Intern(key), value);
+	}
 
-	ActorEncounter::EncounterObj::EncounterObj(SKSE::SerializationInterface* a_intfc)
+	void ActorStats::SetCustomStr(const RE::BSFixedString& key, RE::BSFixedString value)
 	{
-		a_intfc->ReadRecordData(id);
-		a_intfc->ReadRecordData(race);
-		a_intfc->ReadRecordData(sex);
+		SetCustomStr(CustomKeys::GetSingleton()->Intern(key), std::move(value));
 	}
 
-	void ActorEncounter::EncounterObj::Save(SKSE::SerializationInterface* a_intfc)
+	void ActorStats::RemoveCustomStat(const RE::BSFixedString& key)
 	{
-		a_intfc->WriteRecordData(id);
-		a_intfc->WriteRecordData(race);
-		a_intfc->WriteRecordData(sex);
+		RemoveCustomStat(CustomKeys::GetSingleton()->Find(key));
 	}
 
-	ActorEncounter::ActorEncounter(RE::Actor* fst, RE::Actor* snd, EncounterType a_type) :
-		npc1(fst), npc2(snd), _lastmet(0), _timesmet(0), _timesaggressor(0), _timesvictim(0)
+	size_t ActorStats::GetMemoryUsage() const
 	{
-		Update(a_type);
+		constexpr size_t node = sizeof(std::pair<const RE::FormID, ActorStats>) + 4 * sizeof(void*);
+		return node + _stats.capacity() * sizeof(float) + _custom.capacity() * sizeof(std::pair<KeyID, CustomValue>);
 	}
 
-	ActorEncounter::ActorEncounter(SKSE::SerializationInterface* a_intfc) :
-		npc1(a_intfc), npc2(a_intfc)
+	float ActorStats::GetLastAccess() const
 	{
-		if (!a_intfc->ResolveFormID(npc1.id, npc1.id) || !a_intfc->ResolveFormID(npc2.id, npc2.id)) {
-			throw std::exception("Unable to update encounter formid");
-		}
-		a_intfc->ReadRecordData(_lastmet);
-		a_intfc->ReadRecordData(_timesmet);
-		a_intfc->ReadRecordData(_timesaggressor);
-		a_intfc->ReadRecordData(_timesvictim);
-		a_intfc->ReadRecordData(_timesdominant);
-		a_intfc->ReadRecordData(_timessubmissive);
+		return std::max(std::atomic_ref{ _lastaccess }.load(std::memory_order_relaxed), _stats[StatisticID::LastUpdate_GameTime]);
+	}
+
+	void ActorStats::Touch(float a_now) const
+	{
+		std::atomic_ref{ _lastaccess }.store(a_now, std::memory_order_relaxed);
+	}
+
+	ActorEncounter::EncounterObj::EncounterObj(RE::Actor* obj) :
+		id(obj->GetFormID()), race(RaceHandler::GetRaceKey(obj)), sex(Registry::GetSex(obj)) {}
+
+	ActorEncounter::ActorEncounter(RE::Actor* fst, RE::Actor* snd, EncounterType a_type) :
+		npc1(fst), npc2(snd)
+	{
+		Update(a_type);
 	}
 
 	const ActorEncounter::EncounterObj* ActorEncounter::GetPartner(RE::Actor* a_actor) const
 	{
 		if (a_actor->formID == npc1.id)
-			return &npc1;
-		if (a_actor->formID == npc2.id)
 			return &npc2;
+		if (a_actor->formID == npc2.id)
+			return &npc1;
 		return nullptr;
 	}
 
@@ -253,34 +271,178 @@ namespace Registry::Statistics
 
 	void ActorEncounter::Update(EncounterType a_type)
 	{
+		// Counters saturate instead of wrapping around, the history keeps the detail
+		const auto increment = [](uint8_t& a_counter) {
+			if (a_counter < std::numeric_limits<uint8_t>::max())
+				a_counter++;
+		};
 		_lastmet = RE::Calendar::GetSingleton()->GetCurrentGameTime();
-		_timesmet++;
+		_history.Push(_lastmet, a_type);
+		increment(_timesmet);
 		switch (a_type) {
 		case EncounterType::Aggressor:
-			_timesaggressor++;
+			increment(_timesaggressor);
 			__fallthrough;
 		case EncounterType::Dominant:
-			_timesdominant++;
+			increment(_timesdominant);
 			break;
 		case EncounterType::Victim:
-			_timesvictim++;
+			increment(_timesvictim);
 			__fallthrough;
 		case EncounterType::Submissive:
-			_timessubmissive++;
+			increment(_timessubmissive);
 			break;
 		}
 	}
 
-	void ActorEncounter::Save(SKSE::SerializationInterface* a_intfc)
+	void ActorEncounter::History::Push(float a_time, EncounterType a_type)
+	{
+		entries[head] = Entry{ a_time, a_type };
+		head = (head + 1) % CAPACITY;
+		size = std::min<uint8_t>(size + 1, CAPACITY);
+	}
+
+	template <class F>
+	void ActorEncounter::ForEachMatch(RE::FormID a_id, EncounterType a_type, F&& a_func) const
+	{
+		if (a_id != npc1.id && a_id != npc2.id)
+			return;
+		// Entries are recorded from npc1's point of view, npc2 sees the opposite role
+		const auto mirror = a_id != npc1.id;
+		const auto matches = [&](EncounterType a_recorded) {
+			switch (a_type) {
+			case EncounterType::Any:
+				return true;
+			case EncounterType::Victim:
+				return a_recorded == (mirror ? EncounterType::Aggressor : EncounterType::Victim);
+			case EncounterType::Aggressor:
+				return a_recorded == (mirror ? EncounterType::Victim : EncounterType::Aggressor);
+			case EncounterType::Submissive:
+				return mirror ? a_recorded == EncounterType::Aggressor || a_recorded == EncounterType::Dominant :
+												a_recorded == EncounterType::Victim || a_recorded == EncounterType::Submissive;
+			case EncounterType::Dominant:
+				return mirror ? a_recorded == EncounterType::Victim || a_recorded == EncounterType::Submissive :
+												a_recorded == EncounterType::Aggressor || a_recorded == EncounterType::Dominant;
+			default:
+				return false;
+			}
+		};
+		for (uint8_t i = 0; i < _history.Size(); i++) {
+			const auto& entry = _history.At(i);
+			if (matches(entry.type))
+				a_func(entry);
+		}
+	}
+
+	uint32_t ActorEncounter::CountSince(RE::FormID a_id, EncounterType a_type, float a_since) const
+	{
+		uint32_t ret = 0;
+		ForEachMatch(a_id, a_type, [&](const History::Entry& a_entry) {
+			ret += a_entry.time >= a_since;
+		});
+		return ret;
+	}
+
+	float ActorEncounter::GetDecayedWeight(RE::FormID a_id, EncounterType a_type, float a_now, float a_halflife) const
+	{
+		if (a_halflife <= 0.0f)
+			return 0.0f;
+		float ret = 0.0f;
+		ForEachMatch(a_id, a_type, [&](const History::Entry& a_entry) {
+			ret += std::exp2(-std::max(a_now - a_entry.time, 0.0f) / a_halflife);
+		});
+		return ret;
+	}
+
+	uint64_t EncounterStore::GetKey(RE::FormID a_fst, RE::FormID a_snd)
+	{
+		const auto [lo, hi] = std::minmax(a_fst, a_snd);
+		return (static_cast<uint64_t>(hi) << 32) | lo;
+	}
+
+	ActorEncounter* EncounterStore::Find(RE::FormID a_fst, RE::FormID a_snd)
 	{
-		npc1.Save(a_intfc);
-		npc2.Save(a_intfc);
-		a_intfc->WriteRecordData(_lastmet);
-		a_intfc->WriteRecordData(_timesmet);
-		a_intfc->WriteRecordData(_timesaggressor);
-		a_intfc->WriteRecordData(_timesvictim);
-		a_intfc->WriteRecordData(_timesdominant);
-		a_intfc->WriteRecordData(_timessubmissive);
+		const auto where = _index.find(GetKey(a_fst, a_snd));
+		return where == _index.end() ? nullptr : &_encounters[where->second];
+	}
+
+	const ActorEncounter* EncounterStore::Find(RE::FormID a_fst, RE::FormID a_snd) const
+	{
+		const auto where = _index.find(GetKey(a_fst, a_snd));
+		return where == _index.end() ? nullptr : &_encounters[where->second];
+	}
+
+	ActorEncounter& EncounterStore::Insert(ActorEncounter&& a_encounter)
+	{
+		const auto& [fst, snd] = a_encounter.GetParticipants();
+		const auto key = GetKey(fst.id, snd.id);
+		if (const auto where = _index.find(key); where != _index.end()) {
+			return _encounters[where->second] = std::move(a_encounter);
+		}
+		const auto idx = static_cast<uint32_t>(_encounters.size());
+		_index.emplace(key, idx);
+		_adjacency[fst.id].push_back(idx);
+		if (snd.id != fst.id)
+			_adjacency[snd.id].push_back(idx);
+		return _encounters.emplace_back(std::move(a_encounter));
+	}
+
+	void EncounterStore::Erase(RE::FormID a_id)
+	{
+		const auto where = _adjacency.find(a_id);
+		if (where == _adjacency.end())
+			return;
+		// Erase from the back so swapping in the last encounter never invalidates an index still to be erased
+		auto indices = where->second;
+		std::ranges::sort(indices, std::greater{});
+		for (auto&& idx : indices) {
+			EraseAt(idx);
+		}
+		_adjacency.erase(a_id);
+	}
+
+	void EncounterStore::EraseAt(uint32_t a_idx)
+	{
+		const auto unlink = [&](RE::FormID a_id, uint32_t a_from, std::optional<uint32_t> a_to) {
+			const auto adj = _adjacency.find(a_id);
+			if (adj == _adjacency.end())
+				return;
+			const auto it = std::ranges::find(adj->second, a_from);
+			if (it == adj->second.end())
+				return;
+			if (a_to) {
+				*it = *a_to;
+			} else {
+				*it = adj->second.back();
+				adj->second.pop_back();
+				if (adj->second.empty())
+					_adjacency.erase(adj);
+			}
+		};
+		{
+			const auto& [fst, snd] = _encounters[a_idx].GetParticipants();
+			_index.erase(GetKey(fst.id, snd.id));
+			unlink(fst.id, a_idx, std::nullopt);
+			if (snd.id != fst.id)
+				unlink(snd.id, a_idx, std::nullopt);
+		}
+		const auto last = static_cast<uint32_t>(_encounters.size() - 1);
+		if (a_idx != last) {
+			const auto& [fst, snd] = _encounters[last].GetParticipants();
+			_index[GetKey(fst.id, snd.id)] = a_idx;
+			unlink(fst.id, last, a_idx);
+			if (snd.id != fst.id)
+				unlink(snd.id, last, a_idx);
+			_encounters[a_idx] = std::move(_encounters[last]);
+		}
+		_encounters.pop_back();
+	}
+
+	void EncounterStore::Clear()
+	{
+		_encounters.clear();
+		_index.clear();
+		_adjacency.clear();
 	}
 
 	void StatisticsData::Register()
@@ -290,73 +452,251 @@ namespace Registry::Statistics
 		script->AddEventSink<RE::TESResetEvent>(this);
 	}
 
+	namespace
+	{
+		bool IsUniqueActor(RE::Actor* a_actor)
+		{
+			if (a_actor->IsPlayerRef())
+				return true;
+			const auto base = a_actor->GetActorBase();
+			return base && base->IsUnique();
+		}
+	}
+
 	std::vector<RE::Actor*> StatisticsData::GetTrackedActors() const
 	{
 		std::vector<RE::Actor*> ret{};
-		ret.reserve(_data.size());
-		for (auto&& [id, _] : _data) {
-			const auto act = RE::TESForm::LookupByID<RE::Actor>(id);
-			if (!act)
-				continue;
-			ret.push_back(act);
+		for (auto&& shard : _shards) {
+			const std::shared_lock lock{ shard.lock };
+			for (auto&& [id, _] : shard.data) {
+				const auto act = RE::TESForm::LookupByID<RE::Actor>(id);
+				if (!act)
+					continue;
+				ret.push_back(act);
+			}
+		}
+		return ret;
+	}
+
+	std::vector<RE::Actor*> StatisticsData::GetTrackedUniqueActors(size_t a_offset, size_t a_count) const
+	{
+		const std::shared_lock lock{ _uniqueLock };
+		if (a_offset >= _unique.size())
+			return {};
+		const auto last = a_offset + std::min(a_count, _unique.size() - a_offset);
+		std::vector<RE::Actor*> ret{};
+		ret.reserve(last - a_offset);
+		for (size_t i = a_offset; i < last; i++) {
+			if (const auto act = RE::TESForm::LookupByID<RE::Actor>(_unique[i].id))
+				ret.push_back(act);
 		}
 		return ret;
 	}
 
-	ActorStats& StatisticsData::GetStatistics(RE::Actor* a_key)
+	size_t StatisticsData::GetTrackedUniqueActorCount() const
 	{
-		auto where = _data.find(a_key->GetFormID());
-		if (where == _data.end()) {
-			_data.insert(std::make_pair(a_key->GetFormID(), ActorStats{ a_key }));
-			return _data.at(a_key->GetFormID());
+		const std::shared_lock lock{ _uniqueLock };
+		return _unique.size();
+	}
+
+	void StatisticsData::IndexInsert(RE::FormID a_id)
+	{
+		const auto act = RE::TESForm::LookupByID<RE::Actor>(a_id);
+		if (!act || !IsUniqueActor(act))
+			return;
+		const auto name = act->GetDisplayFullName();
+		IndexEntry entry{ static_cast<uint8_t>(act->IsPlayerRef() ? 0 : 1), name ? name : "", a_id };
+		const std::unique_lock lock{ _uniqueLock };
+		_unique.insert(std::ranges::upper_bound(_unique, entry), std::move(entry));
+	}
+
+	void StatisticsData::IndexErase(RE::FormID a_id)
+	{
+		const std::unique_lock lock{ _uniqueLock };
+		std::erase_if(_unique, [&](const IndexEntry& a_entry) { return a_entry.id == a_id; });
+	}
+
+	void StatisticsData::IndexRebuild()
+	{
+		std::vector<IndexEntry> index{};
+		for (auto&& shard : _shards) {
+			const std::shared_lock lock{ shard.lock };
+			for (auto&& [id, _] : shard.data) {
+				const auto act = RE::TESForm::LookupByID<RE::Actor>(id);
+				if (!act || !IsUniqueActor(act))
+					continue;
+				const auto name = act->GetDisplayFullName();
+				index.emplace_back(static_cast<uint8_t>(act->IsPlayerRef() ? 0 : 1), name ? name : "", id);
+			}
 		}
+		std::ranges::sort(index);
+		const std::unique_lock lock{ _uniqueLock };
+		_unique = std::move(index);
+	}
+
+	ActorStats& StatisticsData::FindOrCreate(Shard& a_shard, RE::Actor* a_actor)
+	{
+		auto where = a_shard.data.find(a_actor->GetFormID());
+		if (where == a_shard.data.end()) {
+			where = a_shard.data.emplace(a_actor->GetFormID(), ActorStats{ a_actor }).first;
+			IndexInsert(a_actor->GetFormID());
+		}
+		where->second.Touch(RE::Calendar::GetSingleton()->GetCurrentGameTime());
 		return where->second;
 	}
 
-	ActorEncounter* StatisticsData::GetEncounter(RE::Actor* fst, RE::Actor* snd)
+	StatisticsHandle StatisticsData::GetStatistics(RE::Actor* a_key)
+	{
+		auto& shard = GetShard(a_key->GetFormID());
+		std::unique_lock lock{ shard.lock };
+		auto& stats = FindOrCreate(shard, a_key);
+		return StatisticsHandle{ std::move(lock), stats };
+	}
+
+	ConstStatisticsHandle StatisticsData::ReadStatistics(RE::Actor* a_key)
 	{
-		const auto where = GetEncounterIter(fst, snd);
-		return where == _encounters.end() ? nullptr : &(*where);
+		auto& shard = GetShard(a_key->GetFormID());
+		while (true) {
+			{
+				std::shared_lock lock{ shard.lock };
+				const auto where = shard.data.find(a_key->GetFormID());
+				if (where != shard.data.end()) {
+					where->second.Touch(RE::Calendar::GetSingleton()->GetCurrentGameTime());
+					return ConstStatisticsHandle{ std::move(lock), where->second };
+				}
+			}
+			// A shared_mutex cannot be downgraded, the entry may be deleted again before the next lookup
+			const std::unique_lock lock{ shard.lock };
+			FindOrCreate(shard, a_key);
+		}
 	}
 
-	std::vector<ActorEncounter>::iterator StatisticsData::GetEncounterIter(RE::Actor* fst, RE::Actor* snd)
+	std::vector<float> StatisticsData::GetStatisticMatrix(std::span<RE::Actor* const> a_actors)
 	{
-		return std::ranges::find_if(_encounters, [&](const ActorEncounter& enc) {
-			const auto& [a, b] = enc.GetParticipants();
-			return a.id == fst->formID && b.id == snd->formID || b.id == fst->formID && a.id == snd->formID;
+		std::vector<float> ret(a_actors.size() * ActorStats::Total);
+		const auto now = RE::Calendar::GetSingleton()->GetCurrentGameTime();
+		std::vector<bool> found(a_actors.size(), false);
+		ForEachExistingByShard(a_actors, [&](size_t a_row, const ActorStats& a_stats) {
+			a_stats.Touch(now);
+			std::ranges::copy(a_stats.GetAllStatistics(), ret.begin() + a_row * ActorStats::Total);
+			found[a_row] = true;
 		});
+		// Untracked actors start being tracked, as with GetStatistics
+		for (size_t i = 0; i < a_actors.size(); i++) {
+			if (!a_actors[i] || found[i])
+				continue;
+			const auto stats = GetStatistics(a_actors[i]);
+			std::ranges::copy(stats->GetAllStatistics(), ret.begin() + i * ActorStats::Total);
+		}
+		return ret;
 	}
 
-	void StatisticsData::DeleteStatistics(RE::FormID a_key)
+	std::vector<float> StatisticsData::FindStatisticMatrix(std::span<RE::Actor* const> a_actors, std::vector<bool>* a_found) const
 	{
-		_data.erase(a_key);
-		std::erase_if(_encounters, [&](auto& encounter) {
-			const auto [fst, snd] = encounter.GetParticipants();
-			return fst.id == a_key || snd.id == a_key;
+		std::vector<float> ret(a_actors.size() * ActorStats::Total);
+		if (a_found)
+			a_found->assign(a_actors.size(), false);
+		ForEachExistingByShard(a_actors, [&](size_t a_row, const ActorStats& a_stats) {
+			std::ranges::copy(a_stats.GetAllStatistics(), ret.begin() + a_row * ActorStats::Total);
+			if (a_found)
+				(*a_found)[a_row] = true;
 		});
+		return ret;
 	}
 
-	bool StatisticsData::ForEachStatistic(std::function<bool(ActorStats&)> a_func)
+	void StatisticsData::AddStatistics(std::span<const StatisticDelta> a_deltas)
 	{
-		for (auto&& [_, statistic] : _data) {
-			if (a_func(statistic))
-				return true;
+		std::vector<RE::Actor*> actors{};
+		actors.reserve(a_deltas.size());
+		std::ranges::transform(a_deltas, std::back_inserter(actors), &StatisticDelta::actor);
+		ForEachByShard(actors, [&](size_t a_idx, ActorStats& a_stats) {
+			a_stats.AddStatistic(a_deltas[a_idx].stat, a_deltas[a_idx].value);
+		});
+	}
+
+	std::optional<ActorEncounter> StatisticsData::GetEncounter(RE::Actor* fst, RE::Actor* snd) const
+	{
+		const std::shared_lock lock{ _encounterLock };
+		const auto ret = _encounters.Find(fst->formID, snd->formID);
+		return ret ? std::make_optional(*ret) : std::nullopt;
+	}
+
+	void StatisticsData::DeleteStatistics(RE::FormID a_key)
+	{
+		{
+			auto& shard = GetShard(a_key);
+			const std::unique_lock lock{ shard.lock };
+			if (shard.data.erase(a_key) > 0)
+				IndexErase(a_key);
+		}
+		const std::unique_lock lock{ _encounterLock };
+		_encounters.Erase(a_key);
+	}
+
+	bool StatisticsData::ForEachStatistic(std::function<bool(const ActorStats&)> a_func) const
+	{
+		for (auto&& shard : _shards) {
+			const std::shared_lock lock{ shard.lock };
+			for (auto&& [_, statistic] : shard.data) {
+				if (a_func(statistic))
+					return true;
+			}
 		}
 		return false;
 	}
 
-	bool StatisticsData::ForEachEncounter(std::function<bool(ActorEncounter&)> a_func)
+	bool StatisticsData::ForEachEncounter(std::function<bool(const ActorEncounter&)> a_func) const
 	{
-		for (auto&& encounter : _encounters) {
+		const std::shared_lock lock{ _encounterLock };
+		for (auto&& encounter : _encounters.GetEncounters()) {
 			if (a_func(encounter))
 				return true;
 		}
 		return false;
 	}
 
+	bool StatisticsData::ForEachEncounter(RE::Actor* a_actor, std::function<bool(const ActorEncounter&)> a_func) const
+	{
+		const std::shared_lock lock{ _encounterLock };
+		return _encounters.ForEach(a_actor->formID, a_func);
+	}
+
+	uint32_t StatisticsData::CountRecentEncounters(RE::Actor* a_actor, RE::Actor* a_partner, ActorEncounter::EncounterType a_type, float a_days) const
+	{
+		const auto since = RE::Calendar::GetSingleton()->GetCurrentGameTime() - a_days;
+		const std::shared_lock lock{ _encounterLock };
+		if (a_partner) {
+			const auto enc = _encounters.Find(a_actor->formID, a_partner->formID);
+			return enc ? enc->CountSince(a_actor->formID, a_type, since) : 0;
+		}
+		uint32_t ret = 0;
+		_encounters.ForEach(a_actor->formID, [&](const ActorEncounter& a_encounter) {
+			ret += a_encounter.CountSince(a_actor->formID, a_type, since);
+			return false;
+		});
+		return ret;
+	}
+
+	float StatisticsData::GetEncounterWeight(RE::Actor* a_actor, RE::Actor* a_partner, ActorEncounter::EncounterType a_type, float a_halflife) const
+	{
+		const auto now = RE::Calendar::GetSingleton()->GetCurrentGameTime();
+		const std::shared_lock lock{ _encounterLock };
+		if (a_partner) {
+			const auto enc = _encounters.Find(a_actor->formID, a_partner->formID);
+			return enc ? enc->GetDecayedWeight(a_actor->formID, a_type, now, a_halflife) : 0.0f;
+		}
+		float ret = 0.0f;
+		_encounters.ForEach(a_actor->formID, [&](const ActorEncounter& a_encounter) {
+			ret += a_encounter.GetDecayedWeight(a_actor->formID, a_type, now, a_halflife);
+			return false;
+		});
+		return ret;
+	}
+
 	void StatisticsData::AddEncounter(RE::Actor* fst, RE::Actor* snd, ActorEncounter::EncounterType a_type)
 	{
-		if (auto enc = GetEncounterIter(fst, snd); enc != _encounters.end()) {
+		const std::unique_lock lock{ _encounterLock };
+		if (auto enc = _encounters.Find(fst->formID, snd->formID)) {
 			if (enc->GetParticipants().first.id == snd->formID) {
 				switch (a_type) {
 				case ActorEncounter::EncounterType::Aggressor:
@@ -365,74 +705,77 @@ namespace Registry::Statistics
 				case ActorEncounter::EncounterType::Victim:
 					a_type = ActorEncounter::EncounterType::Aggressor;
 					break;
+				case ActorEncounter::EncounterType::Submissive:
+					a_type = ActorEncounter::EncounterType::Dominant;
+					break;
+				case ActorEncounter::EncounterType::Dominant:
+					a_type = ActorEncounter::EncounterType::Submissive;
+					break;
 				default:
-					a_type = ActorEncounter::EncounterType::Any;
 					break;
 				}
 			}
 			enc->Update(a_type);
-			std::iter_swap(enc, _encounters.end() - 1);
 			return;
 		}
-		_encounters.emplace_back(fst, snd, a_type);
+		_encounters.Insert(ActorEncounter{ fst, snd, a_type });
 	}
 
-	RE::Actor* StatisticsData::GetMostRecentEncounter(RE::Actor* a_actor, ActorEncounter::EncounterType a_type)
+	RE::Actor* StatisticsData::GetMostRecentEncounter(RE::Actor* a_actor, ActorEncounter::EncounterType a_type) const
 	{
-		for (size_t i = _encounters.size() - 1; i >= 0; i--) {
-			const auto partnerobj = _encounters[i].GetPartner(a_actor);
-			const auto partner = partnerobj ? RE::TESForm::LookupByID<RE::Actor>(partnerobj->id) : nullptr;
-			if (!partner)
-				continue;
+		const std::shared_lock lock{ _encounterLock };
+		const ActorEncounter* best = nullptr;
+		_encounters.ForEach(a_actor->formID, [&](const ActorEncounter& enc) {
+			if (best && best->GetLastTimeMet() >= enc.GetLastTimeMet())
+				return false;
 			switch (a_type) {
 			case ActorEncounter::EncounterType::Any:
-				return partner;
+				break;
 			case ActorEncounter::EncounterType::Victim:
-				if (_encounters[i].GetTimesVictim(a_actor->formID) > 0) {
-					return partner;
-				}
+				if (enc.GetTimesVictim(a_actor->formID) == 0)
+					return false;
 				break;
 			case ActorEncounter::EncounterType::Aggressor:
-				if (_encounters[i].GetTimesAssailant(a_actor->formID) > 0) {
-					return partner;
-				}
+				if (enc.GetTimesAssailant(a_actor->formID) == 0)
+					return false;
 				break;
 			case ActorEncounter::EncounterType::Submissive:
-				{
-					if (_encounters[i].GetTimesSubmissive(a_actor->formID) > 0) {
-						return partner;
-					}
-				}
+				if (enc.GetTimesSubmissive(a_actor->formID) == 0)
+					return false;
+				break;
 			case ActorEncounter::EncounterType::Dominant:
-				{
-					if (_encounters[i].GetTimesDominant(a_actor->formID) > 0) {
-						return partner;
-					}
-				}
+				if (enc.GetTimesDominant(a_actor->formID) == 0)
+					return false;
+				break;
 			}
-		}
-		return nullptr;
+			const auto partner = enc.GetPartner(a_actor);
+			if (partner && RE::TESForm::LookupByID<RE::Actor>(partner->id))
+				best = &enc;
+			return false;
+		});
+		return best ? RE::TESForm::LookupByID<RE::Actor>(best->GetPartner(a_actor)->id) : nullptr;
 	}
 
-	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor)
+	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor) const
 	{
 		return GetNumberEncounters(a_actor, ActorEncounter::EncounterType::Any, [](auto&) { return true; });
 	}
-	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type)
+	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type) const
 	{
 		return GetNumberEncounters(a_actor, a_type, [](auto&) { return true; });
 	}
-	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred)
+	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred) const
 	{
 		return GetNumberEncounters(a_actor, ActorEncounter::EncounterType::Any, a_pred);
 	}
-	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred)
+	int StatisticsData::GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred) const
 	{
+		const std::shared_lock lock{ _encounterLock };
 		int ret = 0;
-		for (auto&& encounter : _encounters) {
+		_encounters.ForEach(a_actor->formID, [&](const ActorEncounter& encounter) {
 			const auto partner = encounter.GetPartner(a_actor);
 			if (!partner || !a_pred(*partner))
-				continue;
+				return false;
 			switch (a_type) {
 			case ActorEncounter::EncounterType::Any:
 				ret += encounter.GetTimesMet();
@@ -450,7 +793,8 @@ namespace Registry::Statistics
 				ret += encounter.GetTimesDominant(a_actor->formID);
 				break;
 			}
-		}
+			return false;
+		});
 		return ret;
 	}
 
@@ -474,45 +818,259 @@ namespace Registry::Statistics
 
 	void StatisticsData::Save(SKSE::SerializationInterface* a_intfc)
 	{
-		if (!a_intfc->WriteRecordData(_data.size())) {
-			logger::error("Failed to save number of saved statistics ({})", _data.size());
+		const auto report = Prune();
+		if (report.actors || report.encounters) {
+			logger::info("Dropped {} statistics and {} encounters, reclaimed {} KiB of memory and {} bytes of cosave",
+				report.actors, report.encounters, report.memory / 1024, report.cosave);
+		}
+		const auto snapshot = TakeSnapshot();
+		std::vector<std::byte> buffer{};
+		Serialize(snapshot, buffer);
+		if (buffer.size() > std::numeric_limits<uint32_t>::max()) {
+			logger::error("Statistics record too large ({} bytes)", buffer.size());
 			return;
 		}
-		for (auto&& [id, data] : _data) {
-			if (!a_intfc->WriteRecordData(id)) {
-				logger::error("Failed to save reg ({:X})", id);
-				continue;
+		if (!a_intfc->WriteRecordData(buffer.data(), static_cast<uint32_t>(buffer.size()))) {
+			logger::error("Failed to save statistics ({} bytes)", buffer.size());
+			return;
+		}
+		logger::info("Saved {} statistics and {} encounters ({} bytes)", snapshot.statistics.size(), snapshot.encounters.size(), buffer.size());
+	}
+
+	void StatisticsData::Load(SKSE::SerializationInterface* a_intfc, uint32_t a_version, uint32_t a_length)
+	{
+		StatisticsSnapshot snapshot{};
+		const auto resolve = [&](RE::FormID a_id) -> std::optional<RE::FormID> {
+			RE::FormID ret;
+			if (!a_intfc->ResolveFormID(a_id, ret)) {
+				logger::warn("Error reading formID ({:X})", a_id);
+				return std::nullopt;
 			}
+			return ret;
+		};
+		if (a_version == 1) {
+			// Version 1 wrote the custom value variant as raw bytes, its size has not changed since
+			static_assert(sizeof(ActorStats::CustomValue) == StatsRecord::LEGACY_VARIANT_SIZE);
 			try {
-				data.Save(a_intfc);
+				snapshot = FromRecord(StatsRecord::ReadLegacy(*a_intfc, a_length, ActorStats::Total, resolve));
 			} catch (const std::exception& e) {
-				logger::error("{}", e.what());
+				logger::error("Failed to migrate legacy statistics, Error: {}", e.what());
+				Restore({});
+				return;
 			}
+			logger::info("Migrated {} statistics from legacy record", snapshot.statistics.size());
+			Restore(std::move(snapshot));
+			return;
+		}
+		std::vector<std::byte> buffer(a_length);
+		if (a_intfc->ReadRecordData(buffer.data(), a_length) != a_length) {
+			logger::error("Failed to read statistics record ({} bytes)", a_length);
+			Restore({});
+			return;
+		}
+		try {
+			snapshot = Deserialize(buffer, a_version, resolve);
+		} catch (const std::exception& e) {
+			logger::error("Failed to load statistics, Error: {}", e.what());
+			Restore({});
+			return;
 		}
-		logger::info("Saved {} statistics", _data.size());
+		logger::info("Loaded {} statistics and {} encounters", snapshot.statistics.size(), snapshot.encounters.size());
+		Restore(std::move(snapshot));
 	}
 
-	void StatisticsData::Load(SKSE::SerializationInterface* a_intfc)
+	PruneReport StatisticsData::Prune()
 	{
-		_data.clear();
-		std::size_t numRegs;
-		a_intfc->ReadRecordData(numRegs);
+		const auto now = RE::Calendar::GetSingleton()->GetCurrentGameTime();
+		const auto is_generic = [](RE::FormID a_id) {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(a_id);
+			return !actor || !IsUniqueActor(actor);
+		};
+		struct Candidate
+		{
+			RE::FormID id;
+			float lastaccess;
+			size_t memory;
+		};
+		std::vector<Candidate> candidates{};
+		size_t total = 0;
+		for (auto&& shard : _shards) {
+			const std::shared_lock lock{ shard.lock };
+			for (auto&& [id, stats] : shard.data) {
+				const auto memory = stats.GetMemoryUsage();
+				total += memory;
+				if (is_generic(id))
+					candidates.emplace_back(id, stats.GetLastAccess(), memory);
+			}
+		}
+		{
+			const std::shared_lock lock{ _encounterLock };
+			total += _encounters.Size() * EncounterStore::ENCOUNTER_MEMORY;
+		}
+		// Least recently used first, until the remaining entries fit into the budget
+		const size_t budget = static_cast<size_t>(std::max(Settings::iStatisticsBudget, 0)) * 1024;
+		std::vector<RE::FormID> evict{};
+		if (budget > 0 && total > budget) {
+			std::ranges::sort(candidates, {}, &Candidate::lastaccess);
+			for (auto&& candidate : candidates) {
+				if (total <= budget)
+					break;
+				evict.push_back(candidate.id);
+				total -= candidate.memory;
+			}
+			std::ranges::sort(evict);
+		}
 
-		RE::FormID formID;
-		for (size_t i = 0; i < numRegs; i++) {
-			a_intfc->ReadRecordData(formID);
-			if (!a_intfc->ResolveFormID(formID, formID)) {
-				logger::warn("Error reading formID ({:X})", formID);
+		StatisticsSnapshot dropped{};
+		for (auto&& id : evict) {
+			auto& shard = GetShard(id);
+			const std::unique_lock lock{ shard.lock };
+			const auto where = shard.data.find(id);
+			if (where == shard.data.end())
 				continue;
+			dropped.statistics.emplace_back(id, std::move(where->second));
+			shard.data.erase(where);
+			IndexErase(id);
+		}
+		{
+			const auto retention = Settings::fEncounterRetention;
+			const std::unique_lock lock{ _encounterLock };
+			_encounters.EraseIf([&](const ActorEncounter& a_encounter) {
+				const auto& [fst, snd] = a_encounter.GetParticipants();
+				const auto removed = std::ranges::binary_search(evict, fst.id) || std::ranges::binary_search(evict, snd.id);
+				const auto stale = retention > 0 && now - a_encounter.GetLastTimeMet() > retention && (is_generic(fst.id) || is_generic(snd.id));
+				if (!removed && !stale)
+					return false;
+				dropped.encounters.push_back(a_encounter);
+				return true;
+			});
+		}
+
+		PruneReport ret{ dropped.statistics.size(), dropped.encounters.size() };
+		if (ret.actors == 0 && ret.encounters == 0)
+			return ret;
+		for (auto&& [_, stats] : dropped.statistics) {
+			ret.memory += stats.GetMemoryUsage();
+		}
+		ret.memory += ret.encounters * EncounterStore::ENCOUNTER_MEMORY;
+		std::vector<std::byte> buffer{};
+		Serialize(dropped, buffer);
+		ret.cosave = buffer.size();
+		return ret;
+	}
+
+	StatisticsSnapshot StatisticsData::TakeSnapshot() const
+	{
+		StatisticsSnapshot ret{};
+		for (auto&& shard : _shards) {
+			const std::shared_lock lock{ shard.lock };
+			ret.statistics.insert(ret.statistics.end(), shard.data.begin(), shard.data.end());
+		}
+		std::ranges::sort(ret.statistics, {}, &std::pair<RE::FormID, ActorStats>::first);
+		const std::shared_lock lock{ _encounterLock };
+		ret.encounters = _encounters.GetEncounters();
+		return ret;
+	}
+
+	void StatisticsData::Restore(StatisticsSnapshot&& a_snapshot)
+	{
+		for (auto&& shard : _shards) {
+			const std::unique_lock lock{ shard.lock };
+			shard.data.clear();
+		}
+		for (auto&& [id, stats] : a_snapshot.statistics) {
+			auto& shard = GetShard(id);
+			const std::unique_lock lock{ shard.lock };
+			shard.data.insert_or_assign(id, std::move(stats));
+		}
+		IndexRebuild();
+		const std::unique_lock lock{ _encounterLock };
+		_encounters.Clear();
+		for (auto&& encounter : a_snapshot.encounters) {
+			_encounters.Insert(std::move(encounter));
+		}
+	}
+
+	void StatisticsData::Serialize(const StatisticsSnapshot& a_snapshot, std::vector<std::byte>& a_buffer)
+	{
+		const auto keys = CustomKeys::GetSingleton();
+		StatsRecord::Record record{};
+		record.statistics.reserve(a_snapshot.statistics.size());
+		for (auto&& [id, stats] : a_snapshot.statistics) {
+			auto& entry = record.statistics.emplace_back(id, stats._stats);
+			entry.custom.reserve(stats._custom.size());
+			for (auto&& [key, value] : stats._custom) {
+				if (std::holds_alternative<float>(value)) {
+					entry.custom.emplace_back(keys->GetName(key).c_str(), std::get<float>(value));
+				} else {
+					entry.custom.emplace_back(keys->GetName(key).c_str(), std::get<RE::BSFixedString>(value).c_str());
+				}
+			}
+		}
+		record.encounters.reserve(a_snapshot.encounters.size());
+		for (auto&& enc : a_snapshot.encounters) {
+			auto& entry = record.encounters.emplace_back(
+				enc.npc1.id, enc.npc2.id,
+				std::to_underlying(enc.npc1.race), std::to_underlying(enc.npc2.race),
+				std::to_underlying(enc.npc1.sex), std::to_underlying(enc.npc2.sex),
+				enc._lastmet, enc._timesmet, enc._timessubmissive, enc._timesdominant, enc._timesvictim, enc._timesaggressor);
+			entry.history.reserve(enc._history.Size());
+			for (uint8_t i = 0; i < enc._history.Size(); i++) {
+				const auto& it = enc._history.At(i);
+				entry.history.emplace_back(it.time, static_cast<uint8_t>(it.type));
+			}
+		}
+		StatsRecord::Serialize(record, ActorStats::Total, a_buffer);
+	}
+
+	StatisticsSnapshot StatisticsData::Deserialize(std::span<const std::byte> a_buffer, uint32_t a_version, const std::function<std::optional<RE::FormID>(RE::FormID)>& a_resolve)
+	{
+		return FromRecord(StatsRecord::Deserialize(a_buffer, a_version, a_resolve));
+	}
+
+	StatisticsSnapshot StatisticsData::FromRecord(StatsRecord::Record&& a_record)
+	{
+		StatisticsSnapshot ret{};
+		const auto keys = CustomKeys::GetSingleton();
+		ret.statistics.reserve(a_record.statistics.size());
+		for (auto&& entry : a_record.statistics) {
+			auto& [_, stats] = ret.statistics.emplace_back(entry.id, ActorStats{});
+			// Columns added by a later version are skipped
+			std::copy_n(entry.values.begin(), std::min<size_t>(entry.values.size(), ActorStats::Total), stats._stats.begin());
+			for (auto&& [name, value] : entry.custom) {
+				const auto key = keys->Intern(RE::BSFixedString{ name });
+				if (std::holds_alternative<float>(value)) {
+					stats.SetCustomFlt(key, std::get<float>(value));
+				} else {
+					stats.SetCustomStr(key, RE::BSFixedString{ std::get<std::string>(value) });
+				}
+			}
+		}
+		ret.encounters.reserve(a_record.encounters.size());
+		for (auto&& entry : a_record.encounters) {
+			auto& enc = ret.encounters.emplace_back();
+			enc.npc1.id = entry.npc1;
+			enc.npc2.id = entry.npc2;
+			enc.npc1.race = static_cast<RaceKey>(entry.race1);
+			enc.npc2.race = static_cast<RaceKey>(entry.race2);
+			enc.npc1.sex = static_cast<Sex>(entry.sex1);
+			enc.npc2.sex = static_cast<Sex>(entry.sex2);
+			enc._lastmet = entry.lastmet;
+			enc._timesmet = entry.timesmet;
+			enc._timessubmissive = entry.timessubmissive;
+			enc._timesdominant = entry.timesdominant;
+			enc._timesvictim = entry.timesvictim;
+			enc._timesaggressor = entry.timesaggressor;
+			for (auto&& it : entry.history) {
+				enc._history.Push(it.time, static_cast<ActorEncounter::EncounterType>(it.type));
 			}
-			_data.insert(std::make_pair(formID, ActorStats{ a_intfc }));
 		}
-		logger::info("Loaded {} statistics", _data.size());
+		return ret;
 	}
 
 	void StatisticsData::Revert(SKSE::SerializationInterface*)
 	{
-		_data.clear();
+		Restore({});
 	}
 
 
@@ -2,9 +2,35 @@
 
 #include "Registry/Define/Sex.h"
 #include "Registry/Define/RaceKey.h"
+#include "Registry/Util/StatsRecord.h"
+
+#include <shared_mutex>
 
 namespace Registry::Statistics
 {
+	/// Dense ids for custom statistic names, shared by every actor
+	/// Names are identified by their string pool entry, so a lookup never compares strings
+	/// Ids are stable until the game is closed, they are not written to the cosave
+	class CustomKeys :
+		public Singleton<CustomKeys>
+	{
+	public:
+		using KeyID = uint32_t;
+		static constexpr KeyID INVALID_KEY = std::numeric_limits<int32_t>::max();
+
+		/// @brief Get the id of a_name, assigning a new one if the name has not been seen before
+		_NODISCARD KeyID Intern(const RE::BSFixedString& a_name);
+		/// @return The id of a_name, or INVALID_KEY if the name has never been used
+		_NODISCARD KeyID Find(const RE::BSFixedString& a_name) const;
+		_NODISCARD RE::BSFixedString GetName(KeyID a_id) const;
+		_NODISCARD size_t Size() const;
+
+	private:
+		mutable std::shared_mutex _m{};
+		std::vector<RE::BSFixedString> _names{};
+		std::unordered_map<const char*, KeyID> _ids{};
+	};
+
 	struct ActorStats
 	{
 		enum StatisticID
@@ -33,15 +59,20 @@ namespace Registry::Statistics
 
 			Total
 		};
-		ActorStats(SKSE::SerializationInterface* a_intfc);
 		ActorStats(RE::Actor* owner);
+		ActorStats() :
+			_stats(StatisticID::Total) {}
 		~ActorStats() = default;
 
 		void SetStatistic(StatisticID key, float value);
 		void AddStatistic(StatisticID key, float value);
 		float GetStatistic(StatisticID key) const;
+		std::span<const float> GetAllStatistics() const { return _stats; }
 		std::vector<RE::BSFixedString> GetEveryCustomID() const;
 
+		using KeyID = CustomKeys::KeyID;
+		using CustomValue = std::variant<float, RE::BSFixedString>;
+
 		bool HasCustom(const RE::BSFixedString& key) const;
 		std::optional<float> GetCustomFlt(const RE::BSFixedString& key) const;
 		std::optional<RE::BSFixedString> GetCustomStr(const RE::BSFixedString& key) const;
@@ -49,25 +80,39 @@ namespace Registry::Statistics
 		void SetCustomStr(const RE::BSFixedString& key, RE::BSFixedString value);
 		void RemoveCustomStat(const RE::BSFixedString& key);
 
-		void Save(SKSE::SerializationInterface* a_intfc);
+		bool HasCustom(KeyID key) const;
+		std::optional<float> GetCustomFlt(KeyID key) const;
+		std::optional<RE::BSFixedString> GetCustomStr(KeyID key) const;
+		void SetCustomFlt(KeyID key, float value);
+		void SetCustomStr(KeyID key, RE::BSFixedString value);
+		void RemoveCustomStat(KeyID key);
+
+		/// @brief Approximate heap and node memory held by this entry
+		_NODISCARD size_t GetMemoryUsage() const;
+		/// @brief Game time this entry was last read or written
+		_NODISCARD float GetLastAccess() const;
 
 	private:
+		friend class StatisticsData;
+
+		const CustomValue* FindCustom(KeyID key) const;
+		void SetCustom(KeyID key, CustomValue&& value);
+		/// @brief Record an access at a_now, safe while the shard is only locked shared
+		void Touch(float a_now) const;
+
 		template <class T>
-		std::optional<T> GetCustom(const RE::BSFixedString& key) const
+		std::optional<T> GetCustom(KeyID key) const
 		{
-			const auto it = _custom.find(key);
-			if (it == _custom.end())
+			const auto ret = FindCustom(key);
+			if (!ret || !std::holds_alternative<T>(*ret))
 				return std::nullopt;
 
-			auto& ret = it->second;
-			if (!std::holds_alternative<T>(ret))
-				return std::nullopt;
-
-			return std::get<T>(ret);
+			return std::get<T>(*ret);
 		}
 
 		std::vector<float> _stats{};
-		std::map<RE::BSFixedString, std::variant<float, RE::BSFixedString>, FixedStringCompare> _custom{};
+		std::vector<std::pair<KeyID, CustomValue>> _custom{};	 // sorted by key
+		mutable float _lastaccess{ 0.0f };						 // not persisted, LastUpdate_GameTime covers entries loaded from a save
 	};
 
 	struct ActorEncounter
@@ -84,25 +129,44 @@ namespace Registry::Statistics
 
 		struct EncounterObj
 		{
+			EncounterObj() = default;
 			EncounterObj(RE::Actor* obj);
-			EncounterObj(SKSE::SerializationInterface* a_intfc);
 
-			void Save(SKSE::SerializationInterface* a_intfc);
+			RE::FormID id{ 0 };
+			RaceKey race{ RaceKey::None };
+			Sex sex{ Sex::None };
+		};
 
-			RE::FormID id;
-			RaceKey race;
-			Sex sex;
+		/// The most recent encounters of a pair, the oldest entry is overwritten once full
+		struct History
+		{
+			static constexpr uint8_t CAPACITY = 16;
+
+			struct Entry
+			{
+				float time;					 // game days
+				EncounterType type;	 // as seen by npc1
+			};
+
+			void Push(float a_time, EncounterType a_type);
+			_NODISCARD uint8_t Size() const { return size; }
+			/// @param a_idx 0 for the oldest entry
+			_NODISCARD const Entry& At(uint8_t a_idx) const { return entries[(head + CAPACITY - size + a_idx) % CAPACITY]; }
+
+			std::array<Entry, CAPACITY> entries{};
+			uint8_t head{ 0 };	// next slot to write
+			uint8_t size{ 0 };
 		};
 
 	public:
 		ActorEncounter(RE::Actor* fst, RE::Actor* snd, EncounterType a_type);
-		ActorEncounter(SKSE::SerializationInterface* a_intfc);
+		ActorEncounter() = default;
 		~ActorEncounter() = default;
 
 		void Update(EncounterType a_type);
 
 		std::pair<const EncounterObj&, const EncounterObj&> GetParticipants() const { return { npc1, npc2 }; }
-		const ActorEncounter::EncounterObj* GetPartner(RE::Actor* a_actor) const;
+		const ActorEncounter::EncounterObj* GetPartner(RE::Actor* a_actor) const;	 // the participant which is not a_actor
 		float GetLastTimeMet() const { return _lastmet; }
 		uint8_t GetTimesMet() const { return _timesmet; }
 		uint8_t GetTimesSubmissive(RE::FormID a_id) const;
@@ -110,18 +174,157 @@ namespace Registry::Statistics
 		uint8_t GetTimesVictim(RE::FormID a_id) const;
 		uint8_t GetTimesAssailant(RE::FormID a_id) const;
 
-		void Save(SKSE::SerializationInterface* a_intfc);
+		/// @brief Number of recorded encounters of type a_type (as seen by a_id) at or after a_since
+		uint32_t CountSince(RE::FormID a_id, EncounterType a_type, float a_since) const;
+		/// @brief Sum of recorded encounters of type a_type (as seen by a_id), each weighted by 0.5^(age / a_halflife)
+		float GetDecayedWeight(RE::FormID a_id, EncounterType a_type, float a_now, float a_halflife) const;
+		const History& GetHistory() const { return _history; }
 
 	private:
+		friend class StatisticsData;
+
+		template <class F>
+		void ForEachMatch(RE::FormID a_id, EncounterType a_type, F&& a_func) const;
+
 		EncounterObj npc1;
 		EncounterObj npc2;
 
-		float _lastmet;
-		uint8_t _timesmet;
-		uint8_t _timessubmissive;
-		uint8_t _timesdominant;
-		uint8_t _timesvictim;
-		uint8_t _timesaggressor;
+		float _lastmet{ 0.0f };
+		uint8_t _timesmet{ 0 };
+		uint8_t _timessubmissive{ 0 };
+		uint8_t _timesdominant{ 0 };
+		uint8_t _timesvictim{ 0 };
+		uint8_t _timesaggressor{ 0 };
+		History _history{};
+	};
+
+	/// Encounters indexed by their (unordered) pair of participants and by each participant
+	/// Lookups by pair are O(1), queries for a single actor are O(number of partners)
+	class EncounterStore
+	{
+	public:
+		_NODISCARD static uint64_t GetKey(RE::FormID a_fst, RE::FormID a_snd);
+
+		_NODISCARD ActorEncounter* Find(RE::FormID a_fst, RE::FormID a_snd);
+		_NODISCARD const ActorEncounter* Find(RE::FormID a_fst, RE::FormID a_snd) const;
+		ActorEncounter& Insert(ActorEncounter&& a_encounter);
+		void Erase(RE::FormID a_id);
+		void Clear();
+
+		/// @brief Erase every encounter matching a_pred
+		/// @return The number of erased encounters
+		template <class F>
+		size_t EraseIf(F&& a_pred)
+		{
+			size_t ret = 0;
+			for (uint32_t i = 0; i < _encounters.size();) {
+				if (a_pred(_encounters[i])) {
+					EraseAt(i);	 // moves the last encounter into i
+					ret++;
+				} else {
+					i++;
+				}
+			}
+			return ret;
+		}
+
+		/// @brief Approximate memory held per encounter, including its index and adjacency entries
+		static constexpr size_t ENCOUNTER_MEMORY = sizeof(ActorEncounter) + sizeof(std::pair<uint64_t, uint32_t>) + 3 * sizeof(uint32_t) + 4 * sizeof(void*);
+
+		_NODISCARD size_t Size() const { return _encounters.size(); }
+		_NODISCARD std::vector<ActorEncounter>& GetEncounters() { return _encounters; }
+		_NODISCARD const std::vector<ActorEncounter>& GetEncounters() const { return _encounters; }
+
+		/// @brief Visit every encounter a_id participated in
+		/// @return true if the visitor stopped the iteration
+		template <class F>
+		bool ForEach(RE::FormID a_id, F&& a_func)
+		{
+			const auto where = _adjacency.find(a_id);
+			if (where == _adjacency.end())
+				return false;
+			for (auto&& idx : where->second) {
+				if (a_func(_encounters[idx]))
+					return true;
+			}
+			return false;
+		}
+		template <class F>
+		bool ForEach(RE::FormID a_id, F&& a_func) const
+		{
+			const auto where = _adjacency.find(a_id);
+			if (where == _adjacency.end())
+				return false;
+			for (auto&& idx : where->second) {
+				if (a_func(_encounters[idx]))
+					return true;
+			}
+			return false;
+		}
+
+	private:
+		void EraseAt(uint32_t a_idx);
+
+		std::vector<ActorEncounter> _encounters;
+		std::unordered_map<uint64_t, uint32_t> _index;
+		std::unordered_map<RE::FormID, std::vector<uint32_t>> _adjacency;
+	};
+
+	/// Exclusive access to the statistics of one actor
+	/// Only the shard holding the actor is locked, keep the handle short lived and do not request another actor's statistics while holding it
+	class StatisticsHandle
+	{
+	public:
+		StatisticsHandle(std::unique_lock<std::shared_mutex>&& a_lock, ActorStats& a_stats) :
+			_lock(std::move(a_lock)), _stats(&a_stats) {}
+		~StatisticsHandle() = default;
+
+		ActorStats* operator->() const { return _stats; }
+		ActorStats& operator*() const { return *_stats; }
+
+	private:
+		std::unique_lock<std::shared_mutex> _lock;
+		ActorStats* _stats;
+	};
+
+	/// Shared access to the statistics of one actor, any number of readers may hold a handle to the same shard
+	/// The same rules as for StatisticsHandle apply
+	class ConstStatisticsHandle
+	{
+	public:
+		ConstStatisticsHandle(std::shared_lock<std::shared_mutex>&& a_lock, const ActorStats& a_stats) :
+			_lock(std::move(a_lock)), _stats(&a_stats) {}
+		~ConstStatisticsHandle() = default;
+
+		const ActorStats* operator->() const { return _stats; }
+		const ActorStats& operator*() const { return *_stats; }
+
+	private:
+		std::shared_lock<std::shared_mutex> _lock;
+		const ActorStats* _stats;
+	};
+
+	struct StatisticDelta
+	{
+		RE::Actor* actor;
+		ActorStats::StatisticID stat;
+		float value;
+	};
+
+	/// A copy of every statistic and encounter, detached from the live store
+	/// Every shard and the encounters are copied under their own lock, the copy is consistent per shard but not across shards
+	struct StatisticsSnapshot
+	{
+		std::vector<std::pair<RE::FormID, ActorStats>> statistics{};	// sorted by FormID
+		std::vector<ActorEncounter> encounters{};
+	};
+
+	struct PruneReport
+	{
+		size_t actors{ 0 };
+		size_t encounters{ 0 };
+		size_t memory{ 0 };	 // bytes
+		size_t cosave{ 0 };	 // bytes the dropped entries would have added to the cosave
 	};
 
 	class StatisticsData :
@@ -131,35 +334,149 @@ namespace Registry::Statistics
 	{
 		using EventResult = RE::BSEventNotifyControl;
 
+		// Statistics are spread over shards by FormID, each guarded by its own lock
+		// Lock order is shard -> unique index -> encounters, no code path holds more than one shard at a time
+		static constexpr size_t SHARD_COUNT = 16;
+
 	public:
 		std::vector<RE::Actor*> GetTrackedActors() const;
-		ActorStats& GetStatistics(RE::Actor* a_key);
-		ActorEncounter* GetEncounter(RE::Actor* fst, RE::Actor* snd);
-		std::vector<ActorEncounter>::iterator GetEncounterIter(RE::Actor* fst, RE::Actor* snd);
+		/// @brief Tracked unique actors, the player first and everyone else ordered by display name
+		/// @param a_offset Index of the first actor to return
+		/// @param a_count Maximum number of actors to return
+		std::vector<RE::Actor*> GetTrackedUniqueActors(size_t a_offset, size_t a_count) const;
+		size_t GetTrackedUniqueActorCount() const;
+		/// @brief Exclusive access to the statistics of a_key, creating them if a_key is not tracked yet
+		StatisticsHandle GetStatistics(RE::Actor* a_key);
+		/// @brief Shared access to the statistics of a_key, for reads only
+		/// Only the first access to an untracked actor locks exclusively, to create its statistics
+		ConstStatisticsHandle ReadStatistics(RE::Actor* a_key);
+		/// @brief Every statistic of every actor in a_actors, row major with ActorStats::Total columns per actor
+		/// Rows of none actors are left at 0
+		std::vector<float> GetStatisticMatrix(std::span<RE::Actor* const> a_actors);
+		/// @brief As GetStatisticMatrix, but only reads existing entries and never starts tracking an actor
+		/// Rows of actors without statistics are left at 0
+		/// @param a_found If not null, receives whether each actor in a_actors has statistics
+		std::vector<float> FindStatisticMatrix(std::span<RE::Actor* const> a_actors, std::vector<bool>* a_found = nullptr) const;
+		/// @brief Apply all deltas, locking each involved shard once
+		void AddStatistics(std::span<const StatisticDelta> a_deltas);
+		std::optional<ActorEncounter> GetEncounter(RE::Actor* fst, RE::Actor* snd) const;
 		void DeleteStatistics(RE::FormID a_key);
 
-		bool ForEachStatistic(std::function<bool(ActorStats&)> a_func);
-		bool ForEachEncounter(std::function<bool(ActorEncounter&)> a_func);
+		bool ForEachStatistic(std::function<bool(const ActorStats&)> a_func) const;
+		bool ForEachEncounter(std::function<bool(const ActorEncounter&)> a_func) const;
+		bool ForEachEncounter(RE::Actor* a_actor, std::function<bool(const ActorEncounter&)> a_func) const;
+
+		/// @brief Encounters of a_actor of the given type within the last a_days game days
+		/// @param a_partner The partner to count encounters with, or nullptr to count encounters with anyone
+		uint32_t CountRecentEncounters(RE::Actor* a_actor, RE::Actor* a_partner, ActorEncounter::EncounterType a_type, float a_days) const;
+		/// @brief Recency weighted number of encounters, an encounter a_halflife game days ago counts half
+		/// @param a_partner The partner to weight encounters with, or nullptr to weight encounters with anyone
+		float GetEncounterWeight(RE::Actor* a_actor, RE::Actor* a_partner, ActorEncounter::EncounterType a_type, float a_halflife) const;
 
 		void AddEncounter(RE::Actor* fst, RE::Actor* snd, ActorEncounter::EncounterType a_type);
-		RE::Actor* GetMostRecentEncounter(RE::Actor* a_actor, ActorEncounter::EncounterType a_type);
+		RE::Actor* GetMostRecentEncounter(RE::Actor* a_actor, ActorEncounter::EncounterType a_type) const;
 
-		int GetNumberEncounters(RE::Actor* a_actor);
-		int GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type);
-		int GetNumberEncounters(RE::Actor* a_actor, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred);
-		int GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred);
+		int GetNumberEncounters(RE::Actor* a_actor) const;
+		int GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type) const;
+		int GetNumberEncounters(RE::Actor* a_actor, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred) const;
+		int GetNumberEncounters(RE::Actor* a_actor, ActorEncounter::EncounterType a_type, std::function<bool(const ActorEncounter::EncounterObj&)> a_pred) const;
 
 		EventResult ProcessEvent(const RE::TESDeathEvent* a_event, RE::BSTEventSource<RE::TESDeathEvent>*) override;
 		EventResult ProcessEvent(const RE::TESResetEvent* a_event, RE::BSTEventSource<RE::TESResetEvent>*) override;
 
 		void Register();
 		void Save(SKSE::SerializationInterface* a_intfc);
-		void Load(SKSE::SerializationInterface* a_intfc);
+		void Load(SKSE::SerializationInterface* a_intfc, uint32_t a_version, uint32_t a_length);
 		void Revert(SKSE::SerializationInterface* a_intfc);
 
+		/// @brief Forget stale encounters and, while above the memory budget, the least recently used generic actors
+		/// Unique actors and the player are never dropped, see iStatisticsBudget and fEncounterRetention
+		PruneReport Prune();
+
+		/// @brief Copy the current state, locking one shard at a time, see StatisticsSnapshot
+		_NODISCARD StatisticsSnapshot TakeSnapshot() const;
+		/// @brief Replace all statistics and encounters with the content of a_snapshot
+		void Restore(StatisticsSnapshot&& a_snapshot);
+
+		/// @brief Encode a snapshot into the columnar record layout
+		static void Serialize(const StatisticsSnapshot& a_snapshot, std::vector<std::byte>& a_buffer);
+		/// @brief Decode a columnar (version 2+) record
+		/// @param a_resolve Maps a saved FormID to its id in the current load order, or nullopt if the form no longer exists
+		static StatisticsSnapshot Deserialize(std::span<const std::byte> a_buffer, uint32_t a_version, const std::function<std::optional<RE::FormID>(RE::FormID)>& a_resolve);
+
 	private:
-		std::vector<ActorEncounter> _encounters;
-		std::map<RE::FormID, ActorStats> _data;
+		static StatisticsSnapshot FromRecord(StatsRecord::Record&& a_record);
+
+		struct Shard
+		{
+			mutable std::shared_mutex lock{};
+			std::map<RE::FormID, ActorStats> data{};
+		};
+		_NODISCARD static size_t GetShardIndex(RE::FormID a_id) { return (a_id ^ (a_id >> 12)) % SHARD_COUNT; }
+		_NODISCARD Shard& GetShard(RE::FormID a_id) { return _shards[GetShardIndex(a_id)]; }
+		_NODISCARD const Shard& GetShard(RE::FormID a_id) const { return _shards[GetShardIndex(a_id)]; }
+		/// @brief Get or create the statistics of a_actor, the caller must hold a_shard's lock exclusively
+		ActorStats& FindOrCreate(Shard& a_shard, RE::Actor* a_actor);
+		/// @brief Group a_actors by the shard holding them and lock each shard once
+		template <class F>
+		void ForEachByShard(std::span<RE::Actor* const> a_actors, F&& a_func)
+		{
+			const auto groups = GroupByShard(a_actors);
+			for (size_t n = 0; n < SHARD_COUNT; n++) {
+				if (groups[n].empty())
+					continue;
+				auto& shard = _shards[n];
+				const std::unique_lock lock{ shard.lock };
+				for (auto&& i : groups[n]) {
+					a_func(i, FindOrCreate(shard, a_actors[i]));
+				}
+			}
+		}
+		/// @brief As ForEachByShard, but shares each shard's lock and skips actors without statistics
+		template <class F>
+		void ForEachExistingByShard(std::span<RE::Actor* const> a_actors, F&& a_func) const
+		{
+			const auto groups = GroupByShard(a_actors);
+			for (size_t n = 0; n < SHARD_COUNT; n++) {
+				if (groups[n].empty())
+					continue;
+				const auto& shard = _shards[n];
+				const std::shared_lock lock{ shard.lock };
+				for (auto&& i : groups[n]) {
+					const auto where = shard.data.find(a_actors[i]->GetFormID());
+					if (where != shard.data.end())
+						a_func(i, where->second);
+				}
+			}
+		}
+		_NODISCARD static std::array<std::vector<size_t>, SHARD_COUNT> GroupByShard(std::span<RE::Actor* const> a_actors)
+		{
+			std::array<std::vector<size_t>, SHARD_COUNT> ret{};
+			for (size_t i = 0; i < a_actors.size(); i++) {
+				if (a_actors[i])
+					ret[GetShardIndex(a_actors[i]->GetFormID())].push_back(i);
+			}
+			return ret;
+		}
+
+		// Name ordered index of tracked unique actors, names are captured when an actor starts being tracked
+		struct IndexEntry
+		{
+			uint8_t group;	// 0 for the player, 1 otherwise
+			std::string name;
+			RE::FormID id;
+
+			auto operator<=>(const IndexEntry&) const = default;
+		};
+		void IndexInsert(RE::FormID a_id);
+		void IndexErase(RE::FormID a_id);
+		void IndexRebuild();
+
+		std::array<Shard, SHARD_COUNT> _shards{};
+		mutable std::shared_mutex _uniqueLock{};
+		std::vector<IndexEntry> _unique{};
+		mutable std::shared_mutex _encounterLock{};
+		EncounterStore _encounters;
 	};
 
 }	 // namespace Registry::Statistics
@@ -0,0 +1,123 @@
+#pragma once
+
+namespace ByteStream
+{
+	/// @brief Appends values to an in memory buffer, to be written in a single call
+	class Writer
+	{
+	public:
+		Writer(std::vector<std::byte>& a_buffer) :
+			_buffer(a_buffer) {}
+		~Writer() = default;
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		void Write(const T& a_value)
+		{
+			const auto bytes = std::as_bytes(std::span{ &a_value, 1 });
+			_buffer.insert(_buffer.end(), bytes.begin(), bytes.end());
+		}
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		void WriteArray(std::span<const T> a_values)
+		{
+			const auto bytes = std::as_bytes(a_values);
+			_buffer.insert(_buffer.end(), bytes.begin(), bytes.end());
+		}
+
+		/// @brief LEB128, 1 byte for values below 128
+		void WriteVarint(uint64_t a_value)
+		{
+			while (a_value >= 0x80) {
+				_buffer.push_back(static_cast<std::byte>((a_value & 0x7F) | 0x80));
+				a_value >>= 7;
+			}
+			_buffer.push_back(static_cast<std::byte>(a_value));
+		}
+
+		/// @brief Varint of a signed value, small magnitudes of either sign use few bytes
+		void WriteZigZag(int64_t a_value)
+		{
+			WriteVarint((static_cast<uint64_t>(a_value) << 1) ^ static_cast<uint64_t>(a_value >> 63));
+		}
+
+		void WriteString(std::string_view a_value)
+		{
+			WriteVarint(a_value.size());
+			WriteArray(std::span{ a_value.data(), a_value.size() });
+		}
+
+		_NODISCARD size_t Size() const { return _buffer.size(); }
+
+	private:
+		std::vector<std::byte>& _buffer;
+	};
+
+	/// @brief Reads values from an in memory buffer, throwing if the buffer is exhausted
+	class Reader
+	{
+	public:
+		Reader(std::span<const std::byte> a_buffer) :
+			_buffer(a_buffer) {}
+		~Reader() = default;
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		T Read()
+		{
+			T ret;
+			std::memcpy(&ret, Take(sizeof(T)).data(), sizeof(T));
+			return ret;
+		}
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		void ReadArray(std::span<T> a_out)
+		{
+			const auto bytes = Take(a_out.size_bytes());
+			std::memcpy(a_out.data(), bytes.data(), bytes.size());
+		}
+
+		uint64_t ReadVarint()
+		{
+			uint64_t ret = 0;
+			for (uint32_t shift = 0; shift < 64; shift += 7) {
+				const auto byte = std::to_integer<uint64_t>(Take(1)[0]);
+				ret |= (byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+					return ret;
+			}
+			throw std::runtime_error("Malformed varint");
+		}
+
+		int64_t ReadZigZag()
+		{
+			const auto value = ReadVarint();
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+		}
+
+		std::string ReadString()
+		{
+			const auto size = ReadVarint();
+			const auto bytes = Take(size);
+			return std::string{ reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+		}
+
+		_NODISCARD size_t Remaining() const { return _buffer.size() - _offset; }
+
+	private:
+		std::span<const std::byte> Take(size_t a_size)
+		{
+			if (a_size > Remaining())
+				throw std::runtime_error("Unexpected end of buffer");
+			const auto ret = _buffer.subspan(_offset, a_size);
+			_offset += a_size;
+			return ret;
+		}
+
+		std::span<const std::byte> _buffer;
+		size_t _offset{ 0 };
+	};
+
+}	 // namespace ByteStream
@@ -1,35 +1,66 @@
 #pragma once
 
+#include "CellGrid.h"
+
 namespace CellCrawler
 {
-	void ForEachObjectInRange(RE::TESObjectREFR* a_center, float a_radius, std::function<RE::BSContainer::ForEachResult(RE::TESObjectREFR*)> a_callback)
+	/// @brief Cell coordinates of the loaded grid's cell at index (0, 0)
+	inline std::optional<std::pair<int32_t, int32_t>> GetGridOrigin(RE::GridCellArray* a_grids)
+	{
+		// The grid is contiguous, so any cell with known coordinates determines the origin
+		for (uint32_t x = 0; x < a_grids->length; x++) {
+			for (uint32_t y = 0; y < a_grids->length; y++) {
+				const auto gridcell = a_grids->GetCell(x, y);
+				const auto cellCoords = gridcell ? gridcell->GetCoordinates() : nullptr;
+				if (!cellCoords)
+					continue;
+				return std::make_pair(
+					CellGrid::ToCell(cellCoords->worldX) - static_cast<int32_t>(x),
+					CellGrid::ToCell(cellCoords->worldY) - static_cast<int32_t>(y));
+			}
+		}
+		return std::nullopt;
+	}
+
+	/// @brief Visit every attached cell that may contain references within a_radius of a_center
+	template <class F>
+		requires std::invocable<F, RE::TESObjectCELL*>
+	void ForEachCellInRange(const RE::NiPoint3& a_center, float a_radius, F&& a_callback)
 	{
 		const auto TES = RE::TES::GetSingleton();
-    const auto center_coords = a_center->GetPosition();
 		if (const auto interior = TES->interiorCell; interior) {
-			interior->ForEachReferenceInRange(center_coords, a_radius, a_callback);
-		} else if (const auto grids = TES->gridCells; grids) {
-			auto gridLength = grids->length;
-			if (gridLength > 0) {
-				float yPlus = center_coords.y + a_radius;
-				float yMinus = center_coords.y - a_radius;
-				float xPlus = center_coords.x + a_radius;
-				float xMinus = center_coords.x - a_radius;
-				for (uint32_t x = 0, y = 0; (x < gridLength && y < gridLength); x++, y++) {
-					const auto gridcell = grids->GetCell(x, y);
-					if (gridcell && gridcell->IsAttached()) {
-						auto cellCoords = gridcell->GetCoordinates();
-						if (!cellCoords)
-							continue;
-						float worldX = cellCoords->worldX;
-						float worldY = cellCoords->worldY;
-						if (worldX < xPlus && (worldX + 4096.0) > xMinus && worldY < yPlus && (worldY + 4096.0) > yMinus) {
-							gridcell->ForEachReferenceInRange(center_coords, a_radius, a_callback);
-						}
-					}
+			a_callback(interior);
+		} else if (const auto grids = TES->gridCells; grids && grids->length > 0) {
+			const auto origin = GetGridOrigin(grids);
+			if (!origin)
+				return;
+			const auto range = CellGrid::GetOverlap(a_center.x, a_center.y, a_radius, origin->first, origin->second, grids->length);
+			CellGrid::ForEach(range, [&](int32_t x, int32_t y) {
+				const auto gridcell = grids->GetCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+				if (gridcell && gridcell->IsAttached()) {
+					a_callback(gridcell);
 				}
-			}
+			});
 		}
 	}
-} // namespace CellCrawler
 
+	/// @brief Visit every reference within a_radius of a_center
+	/// @param a_callback Invoked with each reference, returning kStop ends the traversal of the current cell
+	template <class F>
+		requires std::invocable<F, RE::TESObjectREFR*>
+	void ForEachObjectInRange(const RE::NiPoint3& a_center, float a_radius, F&& a_callback)
+	{
+		ForEachCellInRange(a_center, a_radius, [&](RE::TESObjectCELL* a_cell) {
+			a_cell->ForEachReferenceInRange(a_center, a_radius, [&](RE::TESObjectREFR* a_ref) {
+				return a_callback(a_ref);
+			});
+		});
+	}
+
+	template <class F>
+		requires std::invocable<F, RE::TESObjectREFR*>
+	void ForEachObjectInRange(RE::TESObjectREFR* a_center, float a_radius, F&& a_callback)
+	{
+		ForEachObjectInRange(a_center->GetPosition(), a_radius, std::forward<F>(a_callback));
+	}
+} // namespace CellCrawler
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace CellGrid
+{
+	static constexpr float CELL_SIZE = 4096.0f;
+
+	/// @brief Inclusive range of indices into a square grid of cells
+	struct Range
+	{
+		int32_t xmin;
+		int32_t xmax;
+		int32_t ymin;
+		int32_t ymax;
+
+		_NODISCARD constexpr bool IsEmpty() const { return xmin > xmax || ymin > ymax; }
+	};
+
+	/// @brief Cell coordinate of the cell containing a_world
+	inline int32_t ToCell(float a_world)
+	{
+		return static_cast<int32_t>(std::floor(a_world / CELL_SIZE));
+	}
+
+	/// @brief Find the grid cells overlapping the bounding square of a circle
+	/// @param a_originX, a_originY Cell coordinates of the cell at grid index (0, 0)
+	/// @param a_length Number of cells along each side of the grid
+	inline Range GetOverlap(float a_x, float a_y, float a_radius, int32_t a_originX, int32_t a_originY, uint32_t a_length)
+	{
+		const auto last = static_cast<int32_t>(a_length) - 1;
+		return Range{
+			std::max(ToCell(a_x - a_radius) - a_originX, 0),
+			std::min(ToCell(a_x + a_radius) - a_originX, last),
+			std::max(ToCell(a_y - a_radius) - a_originY, 0),
+			std::min(ToCell(a_y + a_radius) - a_originY, last),
+		};
+	}
+
+	/// @brief Visit every index in a_range, row by row
+	template <class F>
+		requires std::invocable<F, int32_t, int32_t>
+	void ForEach(const Range& a_range, F&& a_func)
+	{
+		for (int32_t x = a_range.xmin; x <= a_range.xmax; x++) {
+			for (int32_t y = a_range.ymin; y <= a_range.ymax; y++) {
+				a_func(x, y);
+			}
+		}
+	}
+
+}	 // namespace CellGrid
@@ -0,0 +1,92 @@
+#pragma once
+
+namespace Clearance
+{
+	struct Hit
+	{
+		bool hit{ false };
+		glm::vec4 position{};
+	};
+
+	/// @brief Backend answering single ray queries, the game uses havok, anything else may use a synthetic scene
+	class RayCaster
+	{
+	public:
+		virtual ~RayCaster() = default;
+		virtual Hit Cast(const glm::vec4& a_from, const glm::vec4& a_to) = 0;
+	};
+
+	enum class Result
+	{
+		Clear,
+		Blocked,
+		Unknown,	// budget exhausted before the outcome was determined
+	};
+
+	struct Params
+	{
+		float radius{ 32.0f };		 // radius of the disc to sample around the center
+		float step{ 8.0f };				 // distance between two sample points
+		float height{ 16.0f };		 // height of the disc above the center, to not fail on a rug or gold coin
+		float cone{ 128.0f };			 // tip of the upward cone above the center, roughly a NPC height
+		float tolerance{ 8.0f };	 // distance below which a hit is considered to have reached the sample point
+	};
+
+	/// @brief Offsets of all sample points in a disc, ordered coarse to fine
+	/// The center comes first, followed by the cardinal rim points and gradually finer grids, so obstacles are usually found within the first few casts
+	inline std::vector<glm::vec2> GetSampleOrder(float a_radius, float a_step)
+	{
+		const auto n = static_cast<int32_t>(a_radius / a_step);
+		const auto level = [](int32_t a_x, int32_t a_y) {
+			// Number of halvings until the point lies on the grid, the center is on every grid
+			const auto bits = static_cast<uint32_t>(std::abs(a_x) | std::abs(a_y));
+			return bits == 0 ? 0 : 32 - std::countr_zero(bits);
+		};
+		std::vector<std::pair<int32_t, glm::ivec2>> points{};
+		for (int32_t x = -n; x <= n; x++) {
+			for (int32_t y = -n; y <= n; y++) {
+				if (x * x + y * y > n * n)
+					continue;
+				points.emplace_back(level(x, y), glm::ivec2{ x, y });
+			}
+		}
+		std::ranges::stable_sort(points, [](const auto& a_lhs, const auto& a_rhs) {
+			if (a_lhs.first != a_rhs.first)
+				return a_lhs.first < a_rhs.first;
+			// Within a level, rim points first as they are the most likely to touch a wall
+			return a_lhs.second.x * a_lhs.second.x + a_lhs.second.y * a_lhs.second.y > a_rhs.second.x * a_rhs.second.x + a_rhs.second.y * a_rhs.second.y;
+		});
+		std::vector<glm::vec2> ret{};
+		ret.reserve(points.size());
+		for (auto&& [_, point] : points) {
+			ret.emplace_back(glm::vec2(point) * a_step);
+		}
+		return ret;
+	}
+
+	/// @brief Test if the disc around a_center, incl a cone upwards, is free of obstacles
+	/// Each sample point casts a ray from a_origin to the point and a ray from the point to the tip of the cone
+	/// The test stops at the first obstacle or when a_budget runs out
+	/// @param a_order Sample points, as returned by GetSampleOrder()
+	/// @param a_budget Number of casts available, decremented by the number of casts used
+	inline Result Test(RayCaster& a_caster, const glm::vec4& a_origin, const glm::vec3& a_center, std::span<const glm::vec2> a_order, const Params& a_params, uint32_t& a_budget)
+	{
+		const glm::vec4 tip{ a_center.x, a_center.y, a_center.z + a_params.cone, 0.0f };
+		for (auto&& offset : a_order) {
+			// A point needs both casts to be confirmed clear
+			if (a_budget < 2)
+				return Result::Unknown;
+			const glm::vec4 point{ a_center.x + offset.x, a_center.y + offset.y, a_center.z + a_params.height, 0.0f };
+			a_budget--;
+			const auto resA = a_caster.Cast(a_origin, point);
+			if (resA.hit && glm::distance(resA.position, point) > a_params.tolerance)
+				return Result::Blocked;
+			a_budget--;
+			const auto resB = a_caster.Cast(point, tip);
+			if (resB.hit)
+				return Result::Blocked;
+		}
+		return Result::Clear;
+	}
+
+}	 // namespace Clearance
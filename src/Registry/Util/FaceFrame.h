@@ -0,0 +1,99 @@
+#pragma once
+
+namespace FaceFrame
+{
+	/// Layout of a face frame, identical to a level of an expression profile
+	enum : size_t
+	{
+		Phoneme = 0,
+		Modifier = 16,
+		MoodType = 30,
+		MoodValue = 31,
+
+		Total = 32
+	};
+	using Frame = std::array<float, Total>;
+	using Mask = std::bitset<Total>;
+
+	/// @brief a_out = a_base + a_t * a_delta, 4 channels at a time
+	/// @param a_base, a_delta Must be 16 byte aligned
+	inline void Lerp(const float* a_base, const float* a_delta, float a_t, float* a_out)
+	{
+		static_assert(Total % 4 == 0);
+		const auto factor = _mm_set1_ps(a_t);
+		for (size_t i = 0; i < Total; i += 4) {
+			const auto base = _mm_load_ps(a_base + i);
+			const auto delta = _mm_load_ps(a_delta + i);
+			_mm_storeu_ps(a_out + i, _mm_add_ps(base, _mm_mul_ps(delta, factor)));
+		}
+	}
+
+	/// Piecewise linear blend through the levels of an expression profile
+	class Curve
+	{
+		// Interpolation between two adjacent levels, evaluated as base + t * delta
+		struct alignas(16) Segment
+		{
+			Frame base;
+			Frame delta;
+		};
+
+	public:
+		Curve() = default;
+		Curve(std::span<const Frame> a_levels)
+		{
+			if (a_levels.empty())
+				return;
+			_segments.resize(std::max<size_t>(a_levels.size() - 1, 1));
+			for (size_t i = 0; i < _segments.size(); i++) {
+				const auto& from = a_levels[i];
+				const auto& to = a_levels[std::min(i + 1, a_levels.size() - 1)];
+				for (size_t n = 0; n < Total; n++) {
+					_segments[i].base[n] = from[n];
+					_segments[i].delta[n] = to[n] - from[n];
+				}
+			}
+		}
+		~Curve() = default;
+
+		_NODISCARD bool IsEmpty() const { return _segments.empty(); }
+
+		/// @brief Blend the two levels surrounding a_intensity
+		/// @param a_intensity 0 for the first level, 1 for the last
+		/// @return The interpolated values, the mood type is taken from the closer level. All zero if there are no levels
+		_NODISCARD Frame Evaluate(float a_intensity) const
+		{
+			Frame ret{};
+			if (_segments.empty())
+				return ret;
+			const auto position = std::clamp(a_intensity, 0.0f, 1.0f) * _segments.size();
+			const auto idx = std::min(static_cast<size_t>(position), _segments.size() - 1);
+			const auto t = position - idx;
+			const auto& segment = _segments[idx];
+			Lerp(segment.base.data(), segment.delta.data(), t, ret.data());
+			// Mood types are ids and cannot be blended
+			ret[MoodType] = segment.base[MoodType] + (t < 0.5f ? 0.0f : segment.delta[MoodType]);
+			return ret;
+		}
+
+	private:
+		std::vector<Segment> _segments;
+	};
+
+	/// @brief Find the channels which need to be written to turn a_current into a_target
+	/// Mood type and value are set through a single call and are always reported together
+	inline Mask Diff(const Frame& a_current, const Frame& a_target, float a_epsilon)
+	{
+		Mask ret{};
+		for (size_t i = 0; i < Total; i++) {
+			if (std::abs(a_target[i] - a_current[i]) > a_epsilon)
+				ret.set(i);
+		}
+		if (ret[MoodType] || ret[MoodValue]) {
+			ret.set(MoodType);
+			ret.set(MoodValue);
+		}
+		return ret;
+	}
+
+}	 // namespace FaceFrame
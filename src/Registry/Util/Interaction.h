@@ -0,0 +1,558 @@
+#pragma once
+
+#include "Premutation.h"
+
+namespace Interaction
+{
+	/// Upper bound of bodies evaluated together, larger than any scene
+	static constexpr size_t MAX_BODIES = 8;
+
+	/// Sex of a body, bit compatible with Registry::Sex
+	enum SexFlag : uint8_t
+	{
+		Male = 1 << 0,
+		Female = 1 << 1,
+		Futa = 1 << 2,
+	};
+
+	struct TypeData
+	{
+		enum class Type
+		{
+			None = -1,
+			VaginalP = 0,	 // being penetrated (passive)
+			AnalP = 1,
+			VaginalA = 2,	 // penetrating (active)
+			AnalA = 3,
+			Oral = 4,
+			Foot = 5,
+			Hand = 6,
+			Grinding = 7,
+
+			Total,
+		};
+
+		uint32_t _partner{ 0 };		 // actor performing type
+		Type _type{ Type::None };	 // action type performed by partner
+
+		float _velocity{ 0.0f };			// smoothed change of distance, units per ms
+		float _acceleration{ 0.0f };	// smoothed change of velocity, units per ms²
+		float _distance{ 0.0f };
+		float _angle{ 0.0f };	 // angle between the involved nodes, if the test uses one
+	};
+
+	/// Limits of the interaction tests, the defaults match the ones in Settings
+	struct Thresholds
+	{
+		float distanceHead{ 14.7f };
+		float distanceFoot{ 13.3f };
+		float distanceHand{ 8.3f };
+		float distanceCrotch{ 18.0f };
+		float anglePenetration{ 35.0f };
+		float angleGrinding{ 30.0f };
+		float angleMouth{ 30.0f };
+	};
+
+	struct Transform
+	{
+		glm::mat3 rotate{ 1.0f };
+		glm::vec3 translate{ 0.0f };
+	};
+
+	/// @brief Z angle of an XYZ euler decomposition, identical to NiMatrix3::ToEulerAnglesXYZ
+	inline float GetHeading(const glm::mat3& a_rotate)
+	{
+		constexpr float HALF_PI = 1.57079632679489661923f;
+		// glm is column major, a_rotate[c][r] is the engine's entry[r][c]
+		const auto pitch = -std::asin(a_rotate[2][0]);
+		if (pitch >= HALF_PI || pitch <= -HALF_PI)
+			return 0.0f;
+		return -std::atan2(-a_rotate[1][0], a_rotate[0][0]);
+	}
+
+	/// @brief Normalize a_vector in place, vectors too short to have a direction become zero
+	inline void Unitize(glm::vec3& a_vector)
+	{
+		const auto length = glm::length(a_vector);
+		a_vector = length > std::numeric_limits<float>::epsilon() ? a_vector / length : glm::vec3{ 0.0f };
+	}
+
+	/// World transforms of every tracked node of a position, captured once per tick
+	struct NodeFrame
+	{
+		enum NodeID : uint8_t
+		{
+			Head,
+			Pelvis,
+			SpineLower,
+			HandLeft,
+			HandRight,
+			FootLeft,
+			FootRight,
+			Clitoris,
+			SosBase,
+			SosMid,
+			SosFront,
+
+			Total
+		};
+
+	public:
+		bool Has(NodeID a_node) const { return valid.test(a_node); }
+		const Transform& Get(NodeID a_node) const { return world[a_node]; }
+		const glm::vec3& GetTranslate(NodeID a_node) const { return world[a_node].translate; }
+		void Set(NodeID a_node, const Transform& a_transform)
+		{
+			world[a_node] = a_transform;
+			valid.set(a_node);
+		}
+
+		glm::vec3 ApproximateTip() const { return ApproximateNode(20.0f, -4.0f); }
+		glm::vec3 ApproximateMid() const { return ApproximateNode(15.0f, -6.2f); }
+		glm::vec3 ApproximateBase() const { return ApproximateNode(10.0f, -5.0f); }
+
+	private:
+		// Point in front of the pelvis, following its heading
+		glm::vec3 ApproximateNode(float a_forward, float a_upward) const
+		{
+			assert(Has(Pelvis));
+			const auto& pelvis = Get(Pelvis);
+			const auto heading = GetHeading(pelvis.rotate);
+			return pelvis.translate + glm::vec3{ std::cos(heading) * a_forward, std::sin(heading) * a_forward, a_upward };
+		}
+
+	public:
+		std::array<Transform, Total> world{};
+		std::bitset<Total> valid{};
+	};
+
+	/// A position in a single tick, with everything the interaction tests derive from its node frame
+	struct Body
+	{
+		Body(uint32_t a_owner, uint8_t a_sex) :
+			_owner(a_owner), _sex(a_sex) {}
+		Body(uint32_t a_owner, uint8_t a_sex, const NodeFrame& a_frame, const std::vector<TypeData>& a_previous) :
+			Body(a_owner, a_sex) { Prepare(a_frame, a_previous); }
+		~Body() = default;
+
+		/// @brief Derive everything the interaction tests need from the frame of a new tick
+		/// Results of the previous tick are cleared, keeping their storage
+		/// @param a_frame, a_previous Must outlive the evaluation of this tick
+		void Prepare(const NodeFrame& a_frame, const std::vector<TypeData>& a_previous)
+		{
+			_frame = &a_frame;
+			_previous = &a_previous;
+			types.clear();
+
+			const auto zero = glm::vec3{ 0.0f };
+			vCrotch = a_frame.GetTranslate(NodeFrame::Pelvis) - a_frame.GetTranslate(NodeFrame::SpineLower);
+			vSchlong = zero;
+			pGenitalReference = zero;
+			if (!a_frame.Has(NodeFrame::SosMid)) {
+				if (_sex & (SexFlag::Male | SexFlag::Futa))
+					vSchlong = a_frame.ApproximateMid() - a_frame.ApproximateBase();
+			} else if (a_frame.Has(NodeFrame::SosBase)) {
+				vSchlong = a_frame.GetTranslate(NodeFrame::SosMid) - a_frame.GetTranslate(NodeFrame::SosBase);
+			} else if (a_frame.Has(NodeFrame::SosFront)) {
+				vSchlong = a_frame.GetTranslate(NodeFrame::SosFront) - a_frame.GetTranslate(NodeFrame::SosMid);
+			}
+			if (vSchlong == zero) {
+				if (a_frame.Has(NodeFrame::Clitoris))
+					pGenitalReference = a_frame.GetTranslate(NodeFrame::Clitoris);
+			} else {
+				pGenitalReference = a_frame.Has(NodeFrame::SosMid) ? a_frame.GetTranslate(NodeFrame::SosMid) : a_frame.ApproximateMid();
+			}
+			Unitize(vCrotch);
+			Unitize(vSchlong);
+
+			glm::vec3 min{ std::numeric_limits<float>::max() };
+			glm::vec3 max{ std::numeric_limits<float>::lowest() };
+			const auto extend = [&](const glm::vec3& p) {
+				min = glm::min(min, p);
+				max = glm::max(max, p);
+			};
+			for (size_t i = 0; i < NodeFrame::Total; i++) {
+				if (a_frame.Has(NodeFrame::NodeID(i)))
+					extend(a_frame.GetTranslate(NodeFrame::NodeID(i)));
+			}
+			if (pGenitalReference != zero)
+				extend(pGenitalReference);
+			pBoundCenter = (min + max) / 2.0f;
+			fBoundRadius = glm::distance(pBoundCenter, max);
+		}
+
+		const TypeData* GetPrevious(const TypeData& a_type) const
+		{
+			const auto where = std::ranges::find_if(*_previous, [&](auto& type) {
+				return a_type._type == type._type && a_type._partner == type._partner;
+			});
+			return where == _previous->end() ? nullptr : &(*where);
+		}
+
+		/// @brief If any test against a_partner can possibly succeed
+		bool IsInReach(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			static_assert(std::to_underlying(TypeData::Type::Total) == 8, "Update reach for new interaction types");
+			const auto reach = std::max({ a_limits.distanceHead, a_limits.distanceFoot, a_limits.distanceHand, a_limits.distanceCrotch });
+			const auto gap = glm::distance(pBoundCenter, a_partner.pBoundCenter) - fBoundRadius - a_partner.fBoundRadius;
+			return gap <= reach;
+		}
+
+		/// @brief a_partner giving oral to this
+		std::optional<TypeData> GetsOral(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			if (!a_partner._frame->Has(NodeFrame::Head))
+				return std::nullopt;
+			const auto& headworld = a_partner._frame->Get(NodeFrame::Head);
+			if (pGenitalReference == glm::vec3{ 0.0f })
+				return std::nullopt;
+			const auto distance = glm::distance(pGenitalReference, headworld.translate);
+			if (distance > a_limits.distanceHead)
+				return std::nullopt;
+			float angle = 0.0f;
+			if (vSchlong != glm::vec3{ 0.0f }) {
+				const auto vRot = headworld.rotate * vSchlong;
+				const auto dot = glm::dot(vRot, vSchlong);
+				angle = glm::degrees(std::acos(dot));
+				if (angle > a_limits.angleMouth || angle < (180 - a_limits.angleMouth)) {
+					return std::nullopt;
+				}
+			}
+			TypeData ret{};
+			ret._distance = distance;
+			ret._angle = angle;
+			ret._partner = a_partner._owner;
+			ret._type = TypeData::Type::Oral;
+			return ret;
+		}
+
+		/// @brief a_partner pleasuring this with hands
+		std::optional<TypeData> GetsHandjob(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			return GetsLimb(a_partner, NodeFrame::HandLeft, NodeFrame::HandRight, a_limits.distanceHand, TypeData::Type::Hand);
+		}
+
+		/// @brief a_partner pleasuring this with feet
+		std::optional<TypeData> GetsFootjob(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			return GetsLimb(a_partner, NodeFrame::FootLeft, NodeFrame::FootRight, a_limits.distanceFoot, TypeData::Type::Foot);
+		}
+
+		/// @brief a_partner grinding against this
+		std::optional<TypeData> DoesGrinding(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			if (!_frame->Has(NodeFrame::Clitoris))
+				return std::nullopt;
+			const auto& cT = _frame->GetTranslate(NodeFrame::Clitoris);
+			float d;
+			float deg = 0.0f;
+			if (a_partner.vSchlong != glm::vec3{ 0.0f }) {
+				const auto dot = glm::dot(vCrotch, a_partner.vSchlong);
+				deg = glm::degrees(std::acos(dot));
+				if (deg < (180 - a_limits.angleGrinding) || deg > a_limits.angleGrinding) {
+					return std::nullopt;
+				}
+				const auto refP = a_partner._frame->Has(NodeFrame::SosMid) ? a_partner._frame->GetTranslate(NodeFrame::SosMid) : a_partner._frame->ApproximateMid();
+				d = glm::distance(cT, refP);
+			} else {
+				if (!a_partner._frame->Has(NodeFrame::Clitoris))
+					return std::nullopt;
+				d = glm::distance(cT, a_partner._frame->GetTranslate(NodeFrame::Clitoris));
+			}
+			if (d > a_limits.distanceCrotch / 2)
+				return std::nullopt;
+			TypeData ret{};
+			ret._distance = d;
+			ret._angle = deg;
+			ret._partner = a_partner._owner;
+			ret._type = TypeData::Type::Grinding;
+			return ret;
+		}
+
+		/// @brief a_partner penetrating this
+		std::optional<TypeData> HasIntercourse(const Body& a_partner, const Thresholds& a_limits) const
+		{
+			if (a_partner.vSchlong == glm::vec3{ 0.0f }) {
+				return std::nullopt;
+			}
+			const auto dot = glm::dot(vCrotch, a_partner.vSchlong);
+			const auto deg = glm::degrees(std::acos(dot));
+			if (deg < (90 - a_limits.anglePenetration) || deg > (90 + a_limits.anglePenetration)) {
+				return std::nullopt;
+			}
+			assert(_frame->Has(NodeFrame::Pelvis) && _frame->Has(NodeFrame::SpineLower));
+			const auto& refTA = _frame->GetTranslate(NodeFrame::SpineLower);
+			const auto refP = a_partner._frame->Has(NodeFrame::SosMid) ? a_partner._frame->GetTranslate(NodeFrame::SosMid) : a_partner._frame->ApproximateMid();
+			const auto dA = glm::distance(refTA, refP);
+			if (dA > a_limits.distanceCrotch) {
+				return std::nullopt;
+			}
+			TypeData ret{};
+			ret._partner = a_partner._owner;
+			ret._angle = deg;
+			if (_sex != SexFlag::Male) {
+				const auto dV = glm::distance(_frame->GetTranslate(NodeFrame::Pelvis), refP);
+				if (dV < a_limits.distanceCrotch) {
+					ret._distance = dV < dA ? dV : dA;
+					ret._type = dV < dA ? TypeData::Type::VaginalP : TypeData::Type::AnalP;
+					return ret;
+				}
+			}
+			ret._distance = dA;
+			ret._type = TypeData::Type::AnalP;
+			return ret;
+		}
+
+	private:
+		std::optional<TypeData> GetsLimb(const Body& a_partner, NodeFrame::NodeID a_left, NodeFrame::NodeID a_right, float a_reach, TypeData::Type a_type) const
+		{
+			if (pGenitalReference == glm::vec3{ 0.0f })
+				return std::nullopt;
+			for (auto&& limb : { a_left, a_right }) {
+				if (!a_partner._frame->Has(limb))
+					continue;
+				const auto d = glm::distance(a_partner._frame->GetTranslate(limb), pGenitalReference);
+				if (d > a_reach)
+					continue;
+				TypeData ret{};
+				ret._distance = d;
+				ret._partner = a_partner._owner;
+				ret._type = a_type;
+				return ret;
+			}
+			return std::nullopt;
+		}
+
+	public:
+		uint32_t _owner;
+		uint8_t _sex;
+		const NodeFrame* _frame{ nullptr };
+		const std::vector<TypeData>* _previous{ nullptr };
+
+		std::vector<TypeData> types{};
+		glm::vec3 vCrotch{ 0.0f };
+		glm::vec3 vSchlong{ 0.0f };
+		glm::vec3 pGenitalReference{ 0.0f };
+
+		// Sphere enclosing every point used by the interaction tests
+		glm::vec3 pBoundCenter{ 0.0f };
+		float fBoundRadius{ 0.0f };
+	};
+
+	/// @brief Run every interaction test on a set of bodies taken in the same tick
+	/// @param a_data The bodies to evaluate, raw results are stored in each body's types
+	/// @param a_broadphase If pairs whose bounding spheres are out of reach of each other should be skipped
+	/// @param a_pairtimes If not null, receives the time in microseconds spent on each evaluated pair
+	/// @return The number of pairs skipped by the broad phase
+	inline size_t Evaluate(std::vector<Body>& a_data, const Thresholds& a_limits, bool a_broadphase, std::vector<double>* a_pairtimes = nullptr)
+	{
+		const auto update = [](Body& data, std::optional<TypeData> a_type) {
+			if (a_type)
+				data.types.push_back(*a_type);
+			return a_type;
+		};
+		assert(a_data.size() <= MAX_BODIES);
+		std::array<Body*, MAX_BODIES> bodies{};
+		const auto count = std::min(a_data.size(), MAX_BODIES);
+		for (size_t i = 0; i < count; i++) {
+			bodies[i] = &a_data[i];
+			update(a_data[i], a_data[i].GetsHandjob(a_data[i], a_limits));
+		}
+		if (count < 2)
+			return 0;
+		size_t skipped = 0;
+		Combinatorics::for_each_permutation(bodies.begin(), bodies.begin() + 2, bodies.begin() + count,
+			[&](auto start, [[maybe_unused]] auto end) {
+				assert(std::distance(start, end) == 2);
+				const auto t1 = std::chrono::high_resolution_clock::now();
+				auto& fst = **start;
+				auto& snd = **(start + 1);
+				if (a_broadphase && !fst.IsInReach(snd, a_limits)) {
+					skipped++;
+					return false;
+				}
+				update(fst, fst.GetsOral(snd, a_limits));
+				update(fst, fst.GetsHandjob(snd, a_limits));
+				update(fst, fst.GetsFootjob(snd, a_limits));
+				update(fst, fst.DoesGrinding(snd, a_limits));
+				if (auto type = update(fst, fst.HasIntercourse(snd, a_limits))) {
+					TypeData mirror = *type;
+					mirror._partner = fst._owner;
+					mirror._type = type->_type == TypeData::Type::VaginalP ? TypeData::Type::VaginalA : TypeData::Type::AnalA;
+					snd.types.push_back(mirror);
+				}
+				if (a_pairtimes) {
+					std::chrono::duration<double, std::micro> us = std::chrono::high_resolution_clock::now() - t1;
+					a_pairtimes->push_back(us.count());
+				}
+				return false;
+			});
+		return skipped;
+	}
+
+	/// Fixed size record of the recent raw interactions between every pair of positions
+	/// Debounces interactions and smoothes their velocity, all storage is allocated once per scene
+	class History
+	{
+	public:
+		static constexpr size_t CAPACITY{ 128 };
+		static constexpr size_t TYPES{ static_cast<size_t>(TypeData::Type::Total) };
+		static constexpr float SMOOTHING{ 0.5f };	 // weight of the latest sample in velocity and acceleration
+
+		struct Sample
+		{
+			float timestamp;	// ms
+			std::array<float, TYPES> distance;
+			std::array<float, TYPES> angle;
+			std::bitset<TYPES> raw;			 // detected in this tick
+			std::bitset<TYPES> active;	 // reported in this tick, after hysteresis
+		};
+
+		struct Pair
+		{
+			_NODISCARD const Sample& At(size_t a_age) const { return samples[(head + CAPACITY - 1 - a_age) % CAPACITY]; }
+			_NODISCARD const Sample* Latest() const { return size ? &At(0) : nullptr; }
+			Sample& Push(float a_timestamp)
+			{
+				auto& ret = samples[head];
+				head = (head + 1) % CAPACITY;
+				size = std::min(size + 1, CAPACITY);
+				ret.timestamp = a_timestamp;
+				ret.distance.fill(0.0f);
+				ret.angle.fill(0.0f);
+				ret.raw.reset();
+				ret.active.reset();
+				return ret;
+			}
+
+			std::array<Sample, CAPACITY> samples{};
+			size_t head{ 0 };
+			size_t size{ 0 };
+			std::array<uint8_t, TYPES> streak{};	// consecutive ticks in which raw and active state disagree
+			std::array<float, TYPES> velocity{};
+			std::array<float, TYPES> acceleration{};
+		};
+
+	public:
+		History(size_t a_positions) :
+			_count(a_positions), _pairs(a_positions * a_positions) {}
+		~History() = default;
+
+		/// @brief Push the raw interactions of this tick and replace them by the debounced ones
+		/// @param a_bodies The evaluated bodies, their types are overwritten with the reported interactions
+		/// @param a_timestamp The time of this tick in ms
+		/// @param a_enter, a_exit Consecutive ticks an interaction has to be detected or missing before its reported state changes
+		void Update(std::vector<Body>& a_bodies, float a_timestamp, uint8_t a_enter, uint8_t a_exit)
+		{
+			assert(a_bodies.size() == _count);
+			const auto partnerindex = [&](uint32_t a_partner) {
+				const auto where = std::ranges::find(a_bodies, a_partner, [](auto& it) { return it._owner; });
+				return static_cast<size_t>(std::distance(a_bodies.begin(), where));
+			};
+			std::unique_lock lk{ _m };
+			for (size_t i = 0; i < _count; i++) {
+				auto& data = a_bodies[i];
+				for (size_t n = 0; n < _count; n++) {
+					auto& pair = GetPair(i, n);
+					const auto previous = pair.Latest();
+					const auto dt = previous ? std::max(a_timestamp - previous->timestamp, 1.0f) : 0.0f;
+					auto& sample = pair.Push(a_timestamp);
+					for (auto&& type : data.types) {
+						if (partnerindex(type._partner) != n)
+							continue;
+						const auto t = static_cast<size_t>(type._type);
+						sample.raw.set(t);
+						sample.distance[t] = type._distance;
+						sample.angle[t] = type._angle;
+					}
+					for (size_t t = 0; t < TYPES; t++) {
+						const bool wasactive = previous && previous->active.test(t);
+						if (sample.raw.test(t) == wasactive) {
+							pair.streak[t] = 0;
+							sample.active.set(t, wasactive);
+						} else if (++pair.streak[t] >= (wasactive ? a_exit : a_enter)) {
+							pair.streak[t] = 0;
+							sample.active.set(t, !wasactive);
+						} else {
+							sample.active.set(t, wasactive);
+						}
+						if (!sample.raw.test(t)) {
+							// Hold the last known measurement while the interaction is still reported
+							if (previous && sample.active.test(t)) {
+								sample.distance[t] = previous->distance[t];
+								sample.angle[t] = previous->angle[t];
+							}
+							if (!sample.active.test(t)) {
+								pair.velocity[t] = 0.0f;
+								pair.acceleration[t] = 0.0f;
+							}
+							continue;
+						}
+						if (!previous || !previous->raw.test(t)) {
+							continue;
+						}
+						const auto velocity = (sample.distance[t] - previous->distance[t]) / dt;
+						const auto smoothed = SMOOTHING * velocity + (1.0f - SMOOTHING) * pair.velocity[t];
+						const auto acceleration = (smoothed - pair.velocity[t]) / dt;
+						pair.acceleration[t] = SMOOTHING * acceleration + (1.0f - SMOOTHING) * pair.acceleration[t];
+						pair.velocity[t] = smoothed;
+					}
+				}
+			}
+			for (size_t i = 0; i < _count; i++) {
+				auto& types = a_bodies[i].types;
+				types.clear();
+				for (size_t n = 0; n < _count; n++) {
+					const auto& pair = GetPair(i, n);
+					const auto& sample = *pair.Latest();
+					for (size_t t = 0; t < TYPES; t++) {
+						if (!sample.active.test(t))
+							continue;
+						TypeData& type = types.emplace_back();
+						type._partner = a_bodies[n]._owner;
+						type._type = TypeData::Type(t);
+						type._distance = sample.distance[t];
+						type._angle = sample.angle[t];
+						type._velocity = pair.velocity[t];
+						type._acceleration = pair.acceleration[t];
+					}
+				}
+			}
+		}
+
+		/// @brief Get the fraction of the last a_window ms in which an interaction was reported
+		/// The window is limited by the number of stored samples
+		_NODISCARD float GetActiveFraction(size_t a_position, size_t a_partner, TypeData::Type a_type, float a_window) const
+		{
+			std::unique_lock lk{ _m };
+			const auto& pair = GetPair(a_position, a_partner);
+			if (pair.size < 2)
+				return 0.0f;
+			const auto t = static_cast<size_t>(a_type);
+			const auto end = pair.At(0).timestamp;
+			float total = 0.0f, active = 0.0f;
+			// Every sample's state is held from the previous sample up to its own timestamp
+			for (size_t age = 0; age + 1 < pair.size; age++) {
+				const auto& sample = pair.At(age);
+				const auto& before = pair.At(age + 1);
+				const auto begin = std::max(before.timestamp, end - a_window);
+				if (begin >= sample.timestamp)
+					break;
+				const auto span = sample.timestamp - begin;
+				total += span;
+				if (sample.active.test(t))
+					active += span;
+			}
+			return total > 0.0f ? active / total : 0.0f;
+		}
+
+	private:
+		_NODISCARD Pair& GetPair(size_t a_position, size_t a_partner) { return _pairs[a_position * _count + a_partner]; }
+		_NODISCARD const Pair& GetPair(size_t a_position, size_t a_partner) const { return _pairs[a_position * _count + a_partner]; }
+
+		mutable std::mutex _m;
+		size_t _count;
+		std::vector<Pair> _pairs;
+	};
+
+}	 // namespace Interaction
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "Interaction.h"
+
+namespace Interaction::Record
+{
+	/// Binary capture of every tick's node frames, used to replay a scene outside of its original session
+	/// Layout: header, position list, then per tick a timestamp followed by each position's node mask and the transforms of its set nodes
+	static constexpr uint32_t MAGIC{ 'S' << 24 | 'L' << 16 | 'P' << 8 | 'R' };	 // same value as the multichar literal 'SLPR' under MSVC
+	static constexpr uint32_t VERSION{ 1 };
+
+	struct Owner
+	{
+		uint32_t id;
+		uint8_t sex;
+	};
+
+	struct Header
+	{
+		uint32_t interval;	// ms, tick interval at the start of the recording
+		std::vector<Owner> owners;
+	};
+
+	namespace detail
+	{
+		template <class T>
+		void Write(std::ostream& a_stream, const T& a_value)
+		{
+			a_stream.write(reinterpret_cast<const char*>(&a_value), sizeof(T));
+		}
+
+		template <class T>
+		bool Read(std::istream& a_stream, T& a_out)
+		{
+			a_stream.read(reinterpret_cast<char*>(&a_out), sizeof(T));
+			return a_stream.good();
+		}
+
+		// Rotations are stored row major, as the engine's NiMatrix3
+		inline void WriteTransform(std::ostream& a_stream, const Transform& a_transform)
+		{
+			for (glm::length_t r = 0; r < 3; r++) {
+				for (glm::length_t c = 0; c < 3; c++) {
+					Write(a_stream, a_transform.rotate[c][r]);
+				}
+			}
+			Write(a_stream, a_transform.translate.x);
+			Write(a_stream, a_transform.translate.y);
+			Write(a_stream, a_transform.translate.z);
+		}
+
+		inline bool ReadTransform(std::istream& a_stream, Transform& a_out)
+		{
+			for (glm::length_t r = 0; r < 3; r++) {
+				for (glm::length_t c = 0; c < 3; c++) {
+					Read(a_stream, a_out.rotate[c][r]);
+				}
+			}
+			Read(a_stream, a_out.translate.x);
+			Read(a_stream, a_out.translate.y);
+			return Read(a_stream, a_out.translate.z);
+		}
+	}	 // namespace detail
+
+	inline void WriteHeader(std::ostream& a_stream, const Header& a_header)
+	{
+		detail::Write(a_stream, MAGIC);
+		detail::Write(a_stream, VERSION);
+		detail::Write(a_stream, a_header.interval);
+		detail::Write(a_stream, static_cast<uint32_t>(a_header.owners.size()));
+		for (auto&& owner : a_header.owners) {
+			detail::Write(a_stream, owner.id);
+			detail::Write(a_stream, owner.sex);
+		}
+	}
+
+	inline void WriteTick(std::ostream& a_stream, const std::vector<NodeFrame>& a_frames, float a_timestamp)
+	{
+		detail::Write(a_stream, a_timestamp);
+		for (auto&& frame : a_frames) {
+			detail::Write(a_stream, static_cast<uint16_t>(frame.valid.to_ulong()));
+			for (size_t i = 0; i < NodeFrame::Total; i++) {
+				if (frame.valid.test(i))
+					detail::WriteTransform(a_stream, frame.world[i]);
+			}
+		}
+	}
+
+	/// @brief Read and validate the header of a record
+	/// @param a_size Size of the record in bytes, used to reject headers claiming more data than the record holds
+	inline Header ReadHeader(std::istream& a_stream, uint64_t a_size)
+	{
+		constexpr uint64_t FIXED = sizeof(MAGIC) + sizeof(VERSION) + sizeof(Header::interval) + sizeof(uint32_t);
+		constexpr uint64_t OWNER = sizeof(Owner::id) + sizeof(Owner::sex);
+		uint32_t magic, version, count;
+		Header ret{};
+		if (a_size < FIXED || !detail::Read(a_stream, magic) || !detail::Read(a_stream, version) || magic != MAGIC || version != VERSION) {
+			throw std::runtime_error("Invalid record header");
+		}
+		if (!detail::Read(a_stream, ret.interval) || !detail::Read(a_stream, count)) {
+			throw std::runtime_error("Record header is truncated");
+		}
+		if (count == 0 || count > MAX_BODIES || count * OWNER > a_size - FIXED) {
+			throw std::runtime_error("Invalid number of positions: " + std::to_string(count));
+		}
+		ret.owners.resize(count);
+		for (auto&& owner : ret.owners) {
+			detail::Read(a_stream, owner.id);
+			detail::Read(a_stream, owner.sex);
+		}
+		if (!a_stream.good()) {
+			throw std::runtime_error("Record header is truncated");
+		}
+		return ret;
+	}
+
+	/// @brief Read the next tick of a record into a_frames, which must hold one frame per position
+	/// @return False if the record ends before the tick is complete
+	inline bool ReadTick(std::istream& a_stream, std::vector<NodeFrame>& a_frames, float& a_timestamp)
+	{
+		if (!detail::Read(a_stream, a_timestamp))
+			return false;
+		for (auto&& frame : a_frames) {
+			uint16_t mask;
+			if (!detail::Read(a_stream, mask))
+				return false;
+			if (mask >> NodeFrame::Total) {
+				throw std::runtime_error("Invalid node mask");
+			}
+			frame = NodeFrame{};
+			for (size_t i = 0; i < NodeFrame::Total; i++) {
+				if (!(mask & (1 << i)))
+					continue;
+				Transform transform{};
+				if (!detail::ReadTransform(a_stream, transform))
+					return false;
+				frame.Set(NodeFrame::NodeID(i), transform);
+			}
+		}
+		return true;
+	}
+
+	struct Summary
+	{
+		size_t ticks{ 0 };
+		size_t positions{ 0 };
+		size_t evaluated{ 0 };	// pairs run through the interaction tests
+		size_t skipped{ 0 };		// pairs skipped by the broad phase
+		double pairtotal{ 0.0 };	// us
+		double pairaverage{ 0.0 };
+		double pairmaximum{ 0.0 };
+		double tickaverage{ 0.0 };
+		double tickmaximum{ 0.0 };
+		int32_t mismatches{ 0 };	// ticks which differ from the golden output
+		bool truncated{ false };
+
+		std::string ToString() const
+		{
+			const auto pairs = evaluated + skipped;
+			const auto skipratio = pairs == 0 ? 0.0 : static_cast<double>(skipped) / pairs;
+			std::ostringstream ret{};
+			ret << std::fixed << std::setprecision(3)
+					<< "Replayed " << ticks << " ticks with " << positions << " positions; "
+					<< evaluated << " pairs evaluated in " << pairtotal << "us (avg " << pairaverage << "us, max " << pairmaximum << "us); "
+					<< std::setprecision(1) << skipped << " pairs (" << skipratio * 100.0 << "%) skipped by broad phase; "
+					<< std::setprecision(3) << "tick avg " << tickaverage << "us, max " << tickmaximum << "us; "
+					<< mismatches << " ticks differ from golden output";
+			return ret.str();
+		}
+	};
+
+	struct ReplayParams
+	{
+		Thresholds limits{};
+		bool broadphase{ true };
+		uint8_t enter{ 2 };	 // ticks until a detected interaction is reported
+		uint8_t exit{ 3 };	 // ticks until a missing interaction is no longer reported
+	};
+
+	/// @brief Feed a record through the interaction tests and write a report next to it
+	/// The golden output is stored with the extension ".golden", the report with ".report"
+	/// @param a_makegolden If the produced interactions should be stored as the golden output of this record
+	/// @throws std::runtime_error if the record cannot be read
+	inline Summary Replay(const std::filesystem::path& a_file, bool a_makegolden, const ReplayParams& a_params)
+	{
+		std::ifstream stream{ a_file, std::ios::binary };
+		if (!stream.is_open()) {
+			throw std::runtime_error("Unable to open file");
+		}
+		const auto header = ReadHeader(stream, std::filesystem::file_size(a_file));
+		const auto count = header.owners.size();
+
+		const auto join = [](const std::vector<std::string>& a_list) {
+			std::string ret{};
+			for (size_t i = 0; i < a_list.size(); i++) {
+				ret += (i ? ";" : "") + a_list[i];
+			}
+			return ret;
+		};
+		const auto split = [](const std::string& a_line) {
+			std::vector<std::string> ret{};
+			std::istringstream in{ a_line };
+			for (std::string it; std::getline(in, it, ';');) {
+				ret.push_back(it);
+			}
+			return ret;
+		};
+
+		Summary ret{};
+		ret.positions = count;
+		// tick => list of interactions in the format "owner partner type"
+		std::vector<std::vector<std::string>> results{};
+		std::vector<double> pairtimes{};
+		std::vector<double> ticktimes{};
+		std::vector<NodeFrame> frames(count);
+		std::vector<std::vector<TypeData>> previous(count);
+		std::vector<Body> bodies{};
+		bodies.reserve(count);
+		for (auto&& owner : header.owners) {
+			bodies.emplace_back(owner.id, owner.sex);
+		}
+		History history{ count };
+		float timestamp;
+		while (stream.peek() != std::char_traits<char>::eof()) {
+			if (!ReadTick(stream, frames, timestamp)) {
+				ret.truncated = true;
+				break;
+			}
+			for (size_t i = 0; i < count; i++) {
+				if (!frames[i].Has(NodeFrame::Pelvis) || !frames[i].Has(NodeFrame::SpineLower)) {
+					throw std::runtime_error("Record is missing mandatory body nodes");
+				}
+				bodies[i].Prepare(frames[i], previous[i]);
+			}
+			const auto t1 = std::chrono::high_resolution_clock::now();
+			ret.skipped += Evaluate(bodies, a_params.limits, a_params.broadphase, &pairtimes);
+			history.Update(bodies, timestamp, a_params.enter, a_params.exit);
+			std::chrono::duration<double, std::micro> us = std::chrono::high_resolution_clock::now() - t1;
+			ticktimes.push_back(us.count());
+			auto& tick = results.emplace_back();
+			for (size_t i = 0; i < count; i++) {
+				for (auto&& type : bodies[i].types) {
+					std::ostringstream entry{};
+					entry << std::uppercase << std::hex << header.owners[i].id << ' ' << type._partner << ' ' << std::dec << static_cast<int>(type._type);
+					tick.push_back(entry.str());
+				}
+				previous[i].swap(bodies[i].types);
+			}
+			std::ranges::sort(tick);
+		}
+
+		auto goldenpath = a_file;
+		goldenpath.replace_extension(".golden");
+		auto reportpath = a_file;
+		reportpath.replace_extension(".report");
+		std::ofstream report{ reportpath };
+		if (a_makegolden) {
+			std::ofstream golden{ goldenpath };
+			for (auto&& tick : results) {
+				golden << join(tick) << "\n";
+			}
+		} else if (std::ifstream golden{ goldenpath }; golden.is_open()) {
+			std::string line;
+			for (size_t i = 0; i < results.size(); i++) {
+				if (!std::getline(golden, line))
+					line.clear();
+				if (split(line) == results[i]) {
+					continue;
+				}
+				ret.mismatches++;
+				report << "Tick " << i << " differs from golden output. Expected [" << line << "], got [" << join(results[i]) << "]\n";
+			}
+		}
+		for (size_t i = 0; i < results.size(); i++) {
+			report << "Tick " << i << ": " << results[i].size() << " interactions [" << join(results[i]) << "]\n";
+		}
+		ret.ticks = results.size();
+		ret.evaluated = pairtimes.size();
+		ret.pairtotal = std::accumulate(pairtimes.begin(), pairtimes.end(), 0.0);
+		ret.pairaverage = pairtimes.empty() ? 0.0 : ret.pairtotal / pairtimes.size();
+		ret.pairmaximum = pairtimes.empty() ? 0.0 : *std::ranges::max_element(pairtimes);
+		ret.tickaverage = ticktimes.empty() ? 0.0 : std::accumulate(ticktimes.begin(), ticktimes.end(), 0.0) / ticktimes.size();
+		ret.tickmaximum = ticktimes.empty() ? 0.0 : *std::ranges::max_element(ticktimes);
+		report << ret.ToString() << "\n";
+		return ret;
+	}
+
+}	 // namespace Interaction::Record
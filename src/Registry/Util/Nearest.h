@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Nearest
+{
+	/// @brief A candidate and its distance to the query point, computed once before selection
+	template <class T>
+	using Keyed = std::pair<float, T>;
+
+	/// @brief Move the a_count closest candidates to the front, in ascending distance, leaving the rest in unspecified order
+	/// @return The number of selected candidates, at most a_count
+	template <class T>
+	size_t SelectClosest(std::vector<Keyed<T>>& a_candidates, size_t a_count)
+	{
+		const auto count = std::min(a_count, a_candidates.size());
+		const auto mid = a_candidates.begin() + count;
+		if (count < a_candidates.size()) {
+			std::nth_element(a_candidates.begin(), mid, a_candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		}
+		std::sort(a_candidates.begin(), mid, [](const auto& a, const auto& b) { return a.first < b.first; });
+		return count;
+	}
+
+	/// @brief Randomly pick one of a_candidates, the chance of each is inversely proportional to its distance
+	/// @param a_candidates Non empty list of candidates
+	template <class T>
+	const T& PickWeighted(std::span<const Keyed<T>> a_candidates)
+	{
+		assert(!a_candidates.empty());
+		// Distances below 1 unit are treated as 1 to keep weights finite
+		const auto weight = [](float a_distance) { return 1.0f / std::max(a_distance, 1.0f); };
+		float total = 0.0f;
+		for (auto&& [distance, _] : a_candidates) {
+			total += weight(distance);
+		}
+		auto roll = Random::draw<float>(0.0f, total);
+		for (auto&& [distance, value] : a_candidates) {
+			roll -= weight(distance);
+			if (roll <= 0.0f)
+				return value;
+		}
+		return a_candidates.back().second;
+	}
+
+}	 // namespace Nearest
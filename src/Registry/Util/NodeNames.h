@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Interaction.h"
+#include "SceneGraph.h"
+
+namespace NodeNames
+{
+	using NodeFrame = Interaction::NodeFrame;
+
+	static constexpr std::string_view HEAD{ "NPC Head [Head]"sv };				 // Back of throat
+	static constexpr std::string_view PELVIS{ "NPC Pelvis [Pelv]"sv };		 // bottom mid (front)
+	static constexpr std::string_view SPINELOWER{ "NPC Spine [Spn0]"sv };	 // bottom mid (back)
+
+	static constexpr std::string_view HANDLEFT{ "NPC L Finger20 [LF20]"sv };	// Base of middle finger
+	static constexpr std::string_view HANDRIGHT{ "NPC R Finger20 [RF20]"sv };
+	static constexpr std::string_view FOOTLEFT{ "NPC L Foot [Lft ]"sv };	// Ankle
+	static constexpr std::string_view FOOTRIGHT{ "NPC R Foot [Rft ]"sv };
+
+	static constexpr std::string_view CLITORIS{ "Clitoral1"sv };
+	static constexpr std::string_view VAGINA{ "VaginaDeep1"sv };
+	static constexpr std::string_view VAGINALLEFT{ "NPC L Pussy02"sv };
+	static constexpr std::string_view VAGINALRIGHT{ "NPC R Pussy02"sv };
+	static constexpr std::string_view ANAL{ "NPC Anus Deep2"sv };
+	static constexpr std::string_view ANALLEFT{ "NPC LB Anus2"sv };
+	static constexpr std::string_view ANALRIGHT{ "NPC RB Anus2"sv };
+	static constexpr std::array SOSSTART{
+		"NPC Genitals01 [Gen01]"sv, "AH Base"sv, "DD 2"sv, "DD2"sv, "NPC IceGenital02"sv, "BearD 3"sv, "GS 3"sv, "BoarDick01"sv, "RD 2"sv, "CDPenis 2"sv, "CO 2"sv,
+		"ElkD03"sv, "DwarvenSpiderDildo01"sv, "FD 3"sv, "GD 3"sv, "Goat_Penis02"sv, "Horker_Penis04"sv, "HS 3"sv, "SCD 3"sv, "SkeeverD 03"sv, "TD 3"sv, "VLDick03"sv,
+		"WWD 4"sv, "Torso Rock 2a"sv
+	};
+	static constexpr std::array SOSMID{
+		"NPC Genitals04 [Gen04]"sv, "AH 3"sv, "DD 3"sv, "DD3"sv, "NPC IceGenital03"sv, "BearD 6"sv, "GS 4"sv, "BoarDick03"sv, "RD 3"sv, "CDPenis 5"sv, "CO 5"sv,
+		"ElkD04"sv, "DwarvenSpiderDildo02"sv, "FD 4"sv, "GD 4"sv, "Goat_Penis04"sv, "Horker_Penis06"sv, "HS 6"sv, "SCD 4"sv, "SkeeverD 05"sv, "TD 5"sv, "VLDick05"sv,
+		"WWD 7"sv, "Torso Rock 2"sv
+	};
+	static constexpr std::array SOSTIP{
+		"NPC Genitals06 [Gen06]"sv, "AH 6"sv, "DD 6"sv, "DD6"sv, "BearD 8"sv, "GS 7"sv, "BoarDick06"sv, "RD 5"sv, "CDPenis 7"sv, "CO 9"sv, "ElkD06"sv, "DwarvenSpiderDildo03"sv,
+		"FD 7"sv, "GD 7"sv, "Goat_Penis06"sv, "Horker_Penis10"sv, "HS 7"sv, "SCD 7"sv, "SkeeverD 07"sv, "TD 7"sv, "VLDick06"sv, "WWD 9"sv
+	};
+	// Actors with more than 1 schlong
+	static constexpr std::array SOSSTART_ALT{ "RD 2"sv };
+	static constexpr std::array SOSMID_ALT{ "RD 3"sv };
+	static constexpr std::array SOSTIP_ALT{ "RD 5"sv };
+
+	static constexpr std::array BODY{
+		SceneGraph::NodeKey{ HEAD, NodeFrame::Head },
+		SceneGraph::NodeKey{ PELVIS, NodeFrame::Pelvis },
+		SceneGraph::NodeKey{ SPINELOWER, NodeFrame::SpineLower },
+		SceneGraph::NodeKey{ HANDLEFT, NodeFrame::HandLeft },
+		SceneGraph::NodeKey{ HANDRIGHT, NodeFrame::HandRight },
+		SceneGraph::NodeKey{ FOOTLEFT, NodeFrame::FootLeft },
+		SceneGraph::NodeKey{ FOOTRIGHT, NodeFrame::FootRight },
+		SceneGraph::NodeKey{ CLITORIS, NodeFrame::Clitoris },
+	};
+
+	/// Nodes captured for every position, schlong candidates in descending priority
+	static constexpr SceneGraph::NodeTable<BODY.size() + SOSSTART.size() + SOSMID.size() + SOSTIP.size(), NodeFrame::Total> DEFAULT_NODES{
+		SceneGraph::JoinKeys(BODY,
+			SceneGraph::MakeKeys(SOSSTART, NodeFrame::SosBase),
+			SceneGraph::MakeKeys(SOSMID, NodeFrame::SosMid),
+			SceneGraph::MakeKeys(SOSTIP, NodeFrame::SosFront))
+	};
+	static constexpr SceneGraph::NodeTable<BODY.size() + SOSSTART_ALT.size() + SOSMID_ALT.size() + SOSTIP_ALT.size(), NodeFrame::Total> ALTERNATE_NODES{
+		SceneGraph::JoinKeys(BODY,
+			SceneGraph::MakeKeys(SOSSTART_ALT, NodeFrame::SosBase),
+			SceneGraph::MakeKeys(SOSMID_ALT, NodeFrame::SosMid),
+			SceneGraph::MakeKeys(SOSTIP_ALT, NodeFrame::SosFront))
+	};
+
+}	 // namespace NodeNames
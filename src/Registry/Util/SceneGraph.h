@@ -0,0 +1,168 @@
+#pragma once
+
+namespace SceneGraph
+{
+	/// @brief A node to look up in a scene graph
+	struct NodeKey
+	{
+		std::string_view name;
+		uint8_t slot;					 // index in the result array
+		uint8_t priority{ 0 };	// if multiple keys share a slot, the lowest priority found is used
+	};
+
+	/// @brief Create keys for a list of alternative names of the same node, in descending priority
+	template <size_t N>
+	consteval std::array<NodeKey, N> MakeKeys(const std::array<std::string_view, N>& a_names, uint8_t a_slot)
+	{
+		std::array<NodeKey, N> ret{};
+		for (size_t i = 0; i < N; i++) {
+			ret[i] = NodeKey{ a_names[i], a_slot, static_cast<uint8_t>(i) };
+		}
+		return ret;
+	}
+
+	template <size_t... Ns>
+	consteval std::array<NodeKey, (Ns + ...)> JoinKeys(const std::array<NodeKey, Ns>&... a_keys)
+	{
+		std::array<NodeKey, (Ns + ...)> ret{};
+		size_t i = 0;
+		((std::ranges::copy(a_keys, ret.begin() + i), i += Ns), ...);
+		return ret;
+	}
+
+	/// @brief Resolves a fixed set of node names in a single traversal of a scene graph
+	/// Names are matched case insensitive (like BSFixedString) through a perfect hash built at compile time
+	/// @tparam N Number of keys
+	/// @tparam SLOTS Number of distinct nodes to resolve
+	template <size_t N, size_t SLOTS>
+	class NodeTable
+	{
+		static_assert(N > 0 && N < std::numeric_limits<uint8_t>::max());
+		static_assert(SLOTS > 0 && SLOTS <= N);
+
+		// Hash and displace: keys are distributed into buckets, each bucket stores the seed that places its keys into free slots
+		static constexpr size_t BUCKETS = std::max<size_t>(std::bit_ceil(N) / 2, 1);
+		static constexpr size_t TABLE_SIZE = std::bit_ceil(N) * 2;
+		static constexpr uint8_t EMPTY = std::numeric_limits<uint8_t>::max();
+
+	public:
+		template <class T>
+		using Result = std::array<T*, SLOTS>;
+
+		consteval NodeTable(const std::array<NodeKey, N>& a_keys) :
+			_keys(a_keys)
+		{
+			std::array<size_t, N> buckets{};
+			std::array<size_t, BUCKETS + 1> offsets{};
+			for (size_t i = 0; i < N; i++) {
+				const auto& key = _keys[i];
+				if (key.name.empty() || key.slot >= SLOTS)
+					throw "Invalid node key";
+				buckets[i] = Hash(key.name, 0) & (BUCKETS - 1);
+				offsets[buckets[i] + 1]++;
+			}
+			// Group key indices by bucket
+			std::array<size_t, BUCKETS> sizes{};
+			for (size_t b = 0; b < BUCKETS; b++) {
+				sizes[b] = offsets[b + 1];
+				offsets[b + 1] += offsets[b];
+			}
+			std::array<uint8_t, N> grouped{};
+			auto fill = offsets;
+			for (size_t i = 0; i < N; i++) {
+				grouped[fill[buckets[i]]++] = static_cast<uint8_t>(i);
+			}
+			// Largest buckets first, as they are the hardest to place
+			_table.fill(EMPTY);
+			for (auto size = std::ranges::max(sizes); size > 0; size--) {
+				for (size_t b = 0; b < BUCKETS; b++) {
+					if (sizes[b] == size)
+						_seeds[b] = Displace(std::span{ grouped.begin() + offsets[b], size });
+				}
+			}
+		}
+
+		/// @brief Find the key matching the given node name
+		/// @return The matching key, or nullptr if the name is not part of this table
+		constexpr const NodeKey* Find(std::string_view a_name) const
+		{
+			const auto seed = _seeds[Hash(a_name, 0) & (BUCKETS - 1)];
+			const auto idx = _table[Hash(a_name, seed) & (TABLE_SIZE - 1)];
+			if (idx == EMPTY)
+				return nullptr;
+			const auto& key = _keys[idx];
+			return EqualsNoCase(key.name, a_name) ? &key : nullptr;
+		}
+
+		/// @brief Visit every node below (and including) a_root once and collect all nodes of this table
+		/// @param a_traverse Called as a_traverse(a_root, visit), must call visit(T* node, std::string_view name) for every node until visit returns true
+		/// @return The best matching node per slot, nullptr for slots without any match
+		template <class T, class F>
+		Result<T> Resolve(T* a_root, F&& a_traverse) const
+		{
+			Result<T> ret{};
+			std::array<uint8_t, SLOTS> priority{};
+			priority.fill(EMPTY);
+			auto remaining = SLOTS;
+			a_traverse(a_root, [&](T* a_node, std::string_view a_name) {
+				if (a_name.empty())
+					return false;
+				const auto key = Find(a_name);
+				if (!key || key->priority >= priority[key->slot])
+					return false;
+				ret[key->slot] = a_node;
+				priority[key->slot] = key->priority;
+				return key->priority == 0 && --remaining == 0;
+			});
+			return ret;
+		}
+
+	private:
+		consteval uint32_t Displace(std::span<const uint8_t> a_bucket)
+		{
+			for (uint32_t seed = 1; seed < 0x10000; seed++) {
+				size_t placed = 0;
+				for (; placed < a_bucket.size(); placed++) {
+					auto& slot = _table[Hash(_keys[a_bucket[placed]].name, seed) & (TABLE_SIZE - 1)];
+					if (slot != EMPTY)
+						break;
+					slot = a_bucket[placed];
+				}
+				if (placed == a_bucket.size())
+					return seed;
+				// Roll back this attempt
+				for (size_t i = 0; i < placed; i++) {
+					_table[Hash(_keys[a_bucket[i]].name, seed) & (TABLE_SIZE - 1)] = EMPTY;
+				}
+			}
+			throw "Unable to build perfect hash, node keys contain duplicates";
+		}
+
+		static constexpr char Lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c; }
+
+		static constexpr bool EqualsNoCase(std::string_view a_lhs, std::string_view a_rhs)
+		{
+			return a_lhs.size() == a_rhs.size() && std::ranges::equal(a_lhs, a_rhs, {}, Lower, Lower);
+		}
+
+		static constexpr uint32_t Hash(std::string_view a_name, uint32_t a_seed)
+		{
+			// FNV-1a over lowercase characters, with a murmur finalizer to spread the low bits
+			uint32_t h = 2166136261u ^ (a_seed * 0x9E3779B9u);
+			for (auto&& c : a_name) {
+				h ^= static_cast<uint8_t>(Lower(c));
+				h *= 16777619u;
+			}
+			h ^= h >> 16;
+			h *= 0x85EBCA6Bu;
+			h ^= h >> 13;
+			return h;
+		}
+
+	private:
+		std::array<NodeKey, N> _keys{};
+		std::array<uint32_t, BUCKETS> _seeds{};
+		std::array<uint8_t, TABLE_SIZE> _table{};
+	};
+
+}	 // namespace SceneGraph
@@ -0,0 +1,397 @@
+#pragma once
+
+#include "ByteStream.h"
+
+namespace StatsRecord
+{
+	/// Plain form of the statistics cosave record, independent of the game's types
+	/// Version 1 is the original per actor layout written field by field, version 2 and later a columnar byte buffer written in one call
+	/// Version 3 adds the per encounter history
+
+	struct Statistics
+	{
+		using CustomValue = std::variant<float, std::string>;
+
+		uint32_t id;
+		std::vector<float> values;	// one per statistic column
+		std::vector<std::pair<std::string, CustomValue>> custom;
+	};
+
+	struct Encounter
+	{
+		struct Entry
+		{
+			float time;	 // game days
+			uint8_t type;
+		};
+
+		uint32_t npc1;
+		uint32_t npc2;
+		uint8_t race1;
+		uint8_t race2;
+		uint8_t sex1;
+		uint8_t sex2;
+		float lastmet;
+		uint8_t timesmet;
+		uint8_t timessubmissive;
+		uint8_t timesdominant;
+		uint8_t timesvictim;
+		uint8_t timesaggressor;
+		std::vector<Entry> history;	 // oldest first
+	};
+
+	struct Record
+	{
+		std::vector<Statistics> statistics;	 // sorted by id
+		std::vector<Encounter> encounters;
+	};
+
+	/// Maps a saved FormID to its id in the current load order, or nullopt if the form no longer exists
+	using Resolver = std::function<std::optional<uint32_t>(uint32_t)>;
+
+	/// Size of a float custom statistic in a version 1 record
+	/// The legacy writer stored the whole std::variant<float, RE::BSFixedString> as raw bytes, the float at offset 0
+	static constexpr uint32_t LEGACY_VARIANT_SIZE = 16;
+
+	namespace detail
+	{
+		enum class ColumnEncoding : uint8_t
+		{
+			Zero = 0,			// every value is 0, nothing stored
+			Integer = 1,	// every value is integral, stored as zigzag varints
+			Float = 2,		// raw floats
+		};
+
+		enum class CustomKind : uint8_t
+		{
+			Float = 0,
+			String = 1,
+		};
+
+		constexpr float MINUTES_PER_DAY = 24.0f * 60.0f;
+
+		/// Field by field reads from a serialization interface, bounded by the length of the record
+		template <class I>
+		class LegacyReader
+		{
+		public:
+			LegacyReader(I& a_intfc, uint32_t a_length) :
+				_intfc(a_intfc), _remaining(a_length) {}
+
+			template <class T>
+				requires std::is_trivially_copyable_v<T>
+			T Read()
+			{
+				T ret;
+				ReadBytes(&ret, sizeof(T));
+				return ret;
+			}
+
+			void ReadBytes(void* a_out, uint32_t a_size)
+			{
+				if (a_size > _remaining || _intfc.ReadRecordData(a_out, a_size) != a_size)
+					throw std::runtime_error("Unexpected end of record");
+				_remaining -= a_size;
+			}
+
+			/// Length including the terminator, followed by the characters and the terminator
+			std::string ReadString()
+			{
+				const auto size = Read<uint64_t>();
+				if (size == 0 || size > _remaining)
+					throw std::runtime_error("Invalid string length");
+				std::string ret(static_cast<size_t>(size), '\0');
+				ReadBytes(ret.data(), static_cast<uint32_t>(size));
+				ret.resize(static_cast<size_t>(size - 1));
+				return ret;
+			}
+
+		private:
+			I& _intfc;
+			uint32_t _remaining;
+		};
+	}
+
+	/// @brief Encode a record into the columnar layout
+	/// @param a_columns Number of statistic columns to write, missing values are written as 0
+	inline void Serialize(const Record& a_record, size_t a_columns, std::vector<std::byte>& a_buffer)
+	{
+		using namespace detail;
+		const auto& data = a_record.statistics;
+		ByteStream::Writer out{ a_buffer };
+		// FormID column, ascending so deltas stay small
+		out.WriteVarint(data.size());
+		uint32_t previous = 0;
+		for (auto&& entry : data) {
+			out.WriteVarint(entry.id - previous);
+			previous = entry.id;
+		}
+		// One column per statistic
+		out.WriteVarint(a_columns);
+		std::vector<float> column(data.size());
+		for (size_t stat = 0; stat < a_columns; stat++) {
+			bool zero = true, integral = true;
+			for (size_t i = 0; i < data.size(); i++) {
+				const auto value = stat < data[i].values.size() ? data[i].values[stat] : 0.0f;
+				column[i] = value;
+				zero &= value == 0.0f;
+				integral &= std::abs(value) < 0x1p31f && std::trunc(value) == value;
+			}
+			if (zero) {
+				out.Write(ColumnEncoding::Zero);
+			} else if (integral) {
+				out.Write(ColumnEncoding::Integer);
+				for (auto&& value : column) {
+					out.WriteZigZag(static_cast<int64_t>(value));
+				}
+			} else {
+				out.Write(ColumnEncoding::Float);
+				out.WriteArray(std::span<const float>{ column });
+			}
+		}
+		// Custom statistics, names and string values share one dictionary
+		std::vector<std::string_view> dictionary{};
+		std::unordered_map<std::string_view, uint64_t> lookup{};
+		const auto intern = [&](std::string_view a_str) {
+			const auto [where, inserted] = lookup.emplace(a_str, dictionary.size());
+			if (inserted)
+				dictionary.push_back(where->first);
+			return where->second;
+		};
+		std::vector<uint64_t> custom{};
+		for (auto&& entry : data) {
+			custom.push_back(entry.custom.size());
+			for (auto&& [key, value] : entry.custom) {
+				custom.push_back(intern(key));
+				if (std::holds_alternative<float>(value)) {
+					custom.push_back(std::to_underlying(CustomKind::Float));
+					custom.push_back(std::bit_cast<uint32_t>(std::get<float>(value)));
+				} else {
+					custom.push_back(std::to_underlying(CustomKind::String));
+					custom.push_back(intern(std::get<std::string>(value)));
+				}
+			}
+		}
+		out.WriteVarint(dictionary.size());
+		for (auto&& str : dictionary) {
+			out.WriteString(str);
+		}
+		for (auto&& value : custom) {
+			out.WriteVarint(value);
+		}
+		// Encounters
+		const auto& encounters = a_record.encounters;
+		out.WriteVarint(encounters.size());
+		const auto write_column = [&](auto a_get) {
+			for (auto&& enc : encounters) {
+				out.Write(a_get(enc));
+			}
+		};
+		for (auto&& enc : encounters) {
+			out.WriteVarint(enc.npc1);
+			out.WriteVarint(enc.npc2);
+		}
+		write_column([](auto& enc) { return enc.race1; });
+		write_column([](auto& enc) { return enc.race2; });
+		write_column([](auto& enc) { return enc.sex1; });
+		write_column([](auto& enc) { return enc.sex2; });
+		write_column([](auto& enc) { return enc.lastmet; });
+		write_column([](auto& enc) { return enc.timesmet; });
+		write_column([](auto& enc) { return enc.timessubmissive; });
+		write_column([](auto& enc) { return enc.timesdominant; });
+		write_column([](auto& enc) { return enc.timesvictim; });
+		write_column([](auto& enc) { return enc.timesaggressor; });
+		// History, ages relative to the last meeting in game minutes, oldest entry first
+		write_column([](auto& enc) { return static_cast<uint8_t>(enc.history.size()); });
+		for (auto&& enc : encounters) {
+			for (auto&& entry : enc.history) {
+				out.WriteVarint(static_cast<uint64_t>(std::max(enc.lastmet - entry.time, 0.0f) * MINUTES_PER_DAY + 0.5f));
+				out.Write(entry.type);
+			}
+		}
+	}
+
+	/// @brief Decode a columnar (version 2+) record, entries whose forms no longer exist are dropped
+	/// @throws std::runtime_error if the buffer is malformed
+	inline Record Deserialize(std::span<const std::byte> a_buffer, uint32_t a_version, const Resolver& a_resolve)
+	{
+		using namespace detail;
+		Record ret{};
+		ByteStream::Reader in{ a_buffer };
+		const auto count = in.ReadVarint();
+		if (count > in.Remaining()) {
+			throw std::runtime_error("Invalid number of statistics");
+		}
+		std::vector<std::optional<uint32_t>> ids(count);
+		uint32_t previous = 0;
+		for (auto&& id : ids) {
+			previous += static_cast<uint32_t>(in.ReadVarint());
+			id = a_resolve(previous);
+		}
+		const auto columns = in.ReadVarint();
+		if (columns > in.Remaining()) {
+			throw std::runtime_error("Invalid number of columns");
+		}
+		std::vector<Statistics> statistics(count);
+		for (auto&& it : statistics) {
+			it.values.resize(columns);
+		}
+		for (size_t stat = 0; stat < columns; stat++) {
+			const auto encoding = in.Read<ColumnEncoding>();
+			for (auto&& it : statistics) {
+				switch (encoding) {
+				case ColumnEncoding::Zero:
+					it.values[stat] = 0.0f;
+					break;
+				case ColumnEncoding::Integer:
+					it.values[stat] = static_cast<float>(in.ReadZigZag());
+					break;
+				case ColumnEncoding::Float:
+					it.values[stat] = in.Read<float>();
+					break;
+				default:
+					throw std::runtime_error("Unknown column encoding");
+				}
+			}
+		}
+		const auto dictionarysize = in.ReadVarint();
+		if (dictionarysize > in.Remaining()) {
+			throw std::runtime_error("Invalid dictionary size");
+		}
+		std::vector<std::string> dictionary(dictionarysize);
+		for (auto&& str : dictionary) {
+			str = in.ReadString();
+		}
+		const auto lookup = [&](uint64_t a_idx) -> const std::string& {
+			if (a_idx >= dictionary.size())
+				throw std::runtime_error("Invalid dictionary index");
+			return dictionary[a_idx];
+		};
+		for (auto&& it : statistics) {
+			const auto customs = in.ReadVarint();
+			if (customs > in.Remaining()) {
+				throw std::runtime_error("Invalid number of custom statistics");
+			}
+			it.custom.reserve(customs);
+			for (size_t i = 0; i < customs; i++) {
+				const auto& key = lookup(in.ReadVarint());
+				switch (CustomKind(in.ReadVarint())) {
+				case CustomKind::Float:
+					it.custom.emplace_back(key, std::bit_cast<float>(static_cast<uint32_t>(in.ReadVarint())));
+					break;
+				case CustomKind::String:
+					it.custom.emplace_back(key, lookup(in.ReadVarint()));
+					break;
+				default:
+					throw std::runtime_error("Unknown custom statistic kind");
+				}
+			}
+		}
+		for (size_t i = 0; i < count; i++) {
+			if (!ids[i])
+				continue;
+			statistics[i].id = *ids[i];
+			ret.statistics.push_back(std::move(statistics[i]));
+		}
+
+		const auto encountercount = in.ReadVarint();
+		if (encountercount > in.Remaining()) {
+			throw std::runtime_error("Invalid number of encounters");
+		}
+		std::vector<Encounter> encounters(encountercount);
+		std::vector<bool> valid(encountercount, true);
+		for (size_t i = 0; i < encountercount; i++) {
+			const auto fst = a_resolve(static_cast<uint32_t>(in.ReadVarint()));
+			const auto snd = a_resolve(static_cast<uint32_t>(in.ReadVarint()));
+			valid[i] = fst && snd;
+			encounters[i].npc1 = fst.value_or(0);
+			encounters[i].npc2 = snd.value_or(0);
+		}
+		const auto read_column = [&](auto a_get) {
+			for (auto&& enc : encounters) {
+				auto& field = a_get(enc);
+				field = in.Read<std::remove_reference_t<decltype(field)>>();
+			}
+		};
+		read_column([](auto& enc) -> auto& { return enc.race1; });
+		read_column([](auto& enc) -> auto& { return enc.race2; });
+		read_column([](auto& enc) -> auto& { return enc.sex1; });
+		read_column([](auto& enc) -> auto& { return enc.sex2; });
+		read_column([](auto& enc) -> auto& { return enc.lastmet; });
+		read_column([](auto& enc) -> auto& { return enc.timesmet; });
+		read_column([](auto& enc) -> auto& { return enc.timessubmissive; });
+		read_column([](auto& enc) -> auto& { return enc.timesdominant; });
+		read_column([](auto& enc) -> auto& { return enc.timesvictim; });
+		read_column([](auto& enc) -> auto& { return enc.timesaggressor; });
+		if (a_version >= 3) {
+			std::vector<uint8_t> sizes(encountercount);
+			in.ReadArray(std::span{ sizes });
+			for (size_t i = 0; i < encountercount; i++) {
+				auto& enc = encounters[i];
+				enc.history.reserve(sizes[i]);
+				for (uint8_t n = 0; n < sizes[i]; n++) {
+					const auto age = static_cast<float>(in.ReadVarint()) / MINUTES_PER_DAY;
+					const auto type = in.Read<uint8_t>();
+					enc.history.emplace_back(enc.lastmet - age, type);
+				}
+			}
+		}
+		for (size_t i = 0; i < encountercount; i++) {
+			if (valid[i])
+				ret.encounters.push_back(std::move(encounters[i]));
+		}
+		return ret;
+	}
+
+	/// @brief Decode a version 1 record, read field by field from a_intfc
+	/// Layout: uint64 count, then per actor: FormID, a_columns floats, uint64 custom count,
+	/// per custom statistic: key string, int32 kind, then LEGACY_VARIANT_SIZE bytes for a float or a string
+	/// Strings are a uint64 length including the terminator, followed by the characters and the terminator
+	/// @param a_intfc Anything providing ReadRecordData(void*, uint32_t), such as the SKSE serialization interface
+	/// @param a_length Length of the record in bytes
+	/// @throws std::runtime_error if the record ends early or is malformed
+	template <class I>
+	Record ReadLegacy(I& a_intfc, uint32_t a_length, size_t a_columns, const Resolver& a_resolve)
+	{
+		detail::LegacyReader<I> in{ a_intfc, a_length };
+		Record ret{};
+		const auto count = in.template Read<uint64_t>();
+		for (uint64_t i = 0; i < count; i++) {
+			// Always consume the payload, else every following entry is read from the wrong offset
+			Statistics entry{};
+			const auto formid = in.template Read<uint32_t>();
+			entry.values.resize(a_columns);
+			for (auto&& value : entry.values) {
+				value = in.template Read<float>();
+			}
+			const auto customs = in.template Read<uint64_t>();
+			for (uint64_t n = 0; n < customs; n++) {
+				auto key = in.ReadString();
+				switch (in.template Read<int32_t>()) {
+				case 0:
+					{
+						std::array<std::byte, LEGACY_VARIANT_SIZE> raw;
+						in.ReadBytes(raw.data(), LEGACY_VARIANT_SIZE);
+						float value;
+						std::memcpy(&value, raw.data(), sizeof(value));
+						entry.custom.emplace_back(std::move(key), value);
+					}
+					break;
+				case 1:
+					entry.custom.emplace_back(std::move(key), in.ReadString());
+					break;
+				default:
+					throw std::runtime_error("Unknown custom statistic kind");
+				}
+			}
+			const auto id = a_resolve(formid);
+			if (!id)
+				continue;
+			entry.id = *id;
+			ret.statistics.push_back(std::move(entry));
+		}
+		std::ranges::sort(ret.statistics, {}, &Statistics::id);
+		return ret;
+	}
+
+}	 // namespace StatsRecord
@@ -3,9 +3,55 @@
 #include "Define/RaceKey.h"
 #include "Util/Scale.h"
 
+namespace
+{
+	// Everything a validation result depends on and which may change during the lifetime of an actor
+	struct ValidityInputs
+	{
+		const RE::TESRace* race;
+		const RE::NiAVObject* root;	 // a new 3D may come with a different skeleton scale
+		float scale;
+		RE::ACTOR_LIFE_STATE lifestate;
+		uint32_t settings;
+		bool loaded;
+		bool disabled;
+		bool flying;
+		bool mounted;
+		bool animating;
+		bool forbidden;
+
+		bool operator==(const ValidityInputs&) const = default;
+	};
+
+	ValidityInputs GetValidityInputs(RE::Actor* a_actor)
+	{
+		const auto inFaction = [&](RE::TESFaction* a_faction) { return a_faction && a_actor->IsInFaction(a_faction); };
+		return ValidityInputs{
+			.race = a_actor->GetRace(),
+			.root = a_actor->Get3D(),
+			.scale = a_actor->GetScale(),
+			.lifestate = a_actor->GetLifeState(),
+			.settings = Settings::generation.load(),
+			.loaded = a_actor->Is3DLoaded(),
+			.disabled = a_actor->IsDisabled(),
+			.flying = a_actor->IsFlying(),
+			.mounted = a_actor->IsOnMount(),
+			.animating = inFaction(GameForms::AnimatingFaction),
+			.forbidden = inFaction(GameForms::ForbiddenFaction),
+		};
+	}
+
+	constexpr size_t VALIDITY_PRUNE_SIZE = 512;
+
+	std::mutex validity_lock;
+	std::unordered_map<RE::FormID, std::pair<ValidityInputs, int32_t>> validity_cache;
+	std::atomic<uint64_t> validity_hits{ 0 };
+	std::atomic<uint64_t> validity_recomputes{ 0 };
+}
+
 bool Registry::IsValidActor(RE::Actor* a_actor)
 {
-	return IsValidActorImpl(a_actor) > 0;
+	return IsValidActorCached(a_actor) > 0;
 }
 
 int32_t Registry::IsValidActorImpl(RE::Actor* a_actor)
@@ -177,3 +223,39 @@ int32_t Registry::IsValidActorImpl(RE::Actor* a_actor)
 		return -18;
 	}
 }
+
+int32_t Registry::IsValidActorCached(RE::Actor* a_actor, bool& a_recomputed)
+{
+	const auto inputs = GetValidityInputs(a_actor);
+	{
+		const std::scoped_lock lock{ validity_lock };
+		const auto where = validity_cache.find(a_actor->GetFormID());
+		if (where != validity_cache.end() && where->second.first == inputs) {
+			validity_hits++;
+			a_recomputed = false;
+			return where->second.second;
+		}
+	}
+	validity_recomputes++;
+	a_recomputed = true;
+	const auto ret = IsValidActorImpl(a_actor);
+	const std::scoped_lock lock{ validity_lock };
+	if (validity_cache.size() >= VALIDITY_PRUNE_SIZE) {
+		std::erase_if(validity_cache, [](const auto& it) { return !it.second.first.loaded; });
+		if (validity_cache.size() >= VALIDITY_PRUNE_SIZE)
+			validity_cache.clear();
+	}
+	validity_cache.insert_or_assign(a_actor->GetFormID(), std::make_pair(inputs, ret));
+	return ret;
+}
+
+int32_t Registry::IsValidActorCached(RE::Actor* a_actor)
+{
+	bool recomputed;
+	return IsValidActorCached(a_actor, recomputed);
+}
+
+Registry::ValidityCounters Registry::GetValidityCounters()
+{
+	return ValidityCounters{ validity_hits.load(), validity_recomputes.load() };
+}
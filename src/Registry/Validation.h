@@ -6,6 +6,17 @@ namespace Registry
   /// @return some code [1; -inf) if the actor is valid. See implementation for details
 	bool IsValidActor(RE::Actor* a_actor);
 	int32_t IsValidActorImpl(RE::Actor* a_actor);
+	/// @brief IsValidActorImpl, reusing the last result of this actor unless its factions, life state, race, scale or the settings changed
+	/// @param a_recomputed Set if the result had to be computed
+	int32_t IsValidActorCached(RE::Actor* a_actor, bool& a_recomputed);
+	int32_t IsValidActorCached(RE::Actor* a_actor);
+
+	struct ValidityCounters
+	{
+		uint64_t hits;
+		uint64_t recomputes;
+	};
+	ValidityCounters GetValidityCounters();
 
 
 } // namespace Registry
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Registry/Expression.h"
 #include "Registry/Stats.h"
 
 namespace Serialization
@@ -22,7 +23,7 @@ namespace Serialization
 	public:
 		enum : std::uint32_t
 		{
-			_Version = 1,
+			_Version = 3,
 
 			_Statistics = 'stcs'
 		};
@@ -41,14 +42,14 @@ namespace Serialization
 			uint32_t version;
 			uint32_t length;
 			while (a_intfc->GetNextRecordInfo(type, version, length)) {
-				if (version != _Version) {
-					logger::info("Invalid Version for loaded Data of Type = {}. Expected = {}; Got = {}", GetTypeName(type), _Version, version);
+				if (version == 0 || version > _Version) {
+					logger::info("Invalid Version for loaded Data of Type = {}. Expected <= {}; Got = {}", GetTypeName(type), _Version, version);
 					continue;
 				}
 				logger::info("Loading record {}", GetTypeName(type));
 				switch (type) {
 				case _Statistics:
-					Registry::Statistics::StatisticsData::GetSingleton()->Load(a_intfc);
+					Registry::Statistics::StatisticsData::GetSingleton()->Load(a_intfc, version, length);
 					break;
 				default:
 					break;
@@ -61,6 +62,7 @@ namespace Serialization
 		static void RevertCallback(SKSE::SerializationInterface* a_intfc)
 		{
 			Registry::Statistics::StatisticsData::GetSingleton()->Revert(a_intfc);
+			Registry::ExpressionScheduler::GetSingleton()->Clear();
 		}
 
 		static void FormDeleteCallback(RE::VMHandle)
@@ -6,6 +6,7 @@ void Settings::Initialize()
 {
 	InitializeYAML();
 	InitializeINI();
+	generation++;
 }
 
 void Settings::InitializeYAML()
@@ -110,8 +111,11 @@ void Settings::InitializeINI()
 	// Animation
 	READINI("Animation", iFurniturePrefWeight)
 	READINI("Animation", fScanRadius)
+	READINI("Animation", iFurnitureCandidates)
 	READINI("Animation", fMinScale)
 	READINI("Animation", bAllowDead)
+	READINI("Animation", fClearanceCacheTime)
+	READINI("Animation", iClearanceRayBudget)
 
 	// Creature
 	READINI("Creature", bAshHopper)
@@ -170,6 +174,8 @@ void Settings::InitializeINI()
 	// Statistics
 	READINI("Statistics", fPercentageHetero)
 	READINI("Statistics", fPercentageHomo)
+	READINI("Statistics", iStatisticsBudget)
+	READINI("Statistics", fEncounterRetention)
 
 	if (fPercentageHetero + fPercentageHomo > 100) {
 		logger::error("Sexuality Percentage Settings must be at most 100.0");
@@ -186,6 +192,15 @@ void Settings::InitializeINI()
 	READINI("Distance", fAngleGrinding)
 	READINI("Distance", fAngleMouth)
 
+	// Physics
+	READINI("Physics", bRecordPhysics)
+	READINI("Physics", iPhysicsIntervalMin)
+	READINI("Physics", iPhysicsIntervalMax)
+	READINI("Physics", fPhysicsMaxStep)
+	READINI("Physics", bPhysicsBroadPhase)
+	READINI("Physics", iPhysicsEnterTicks)
+	READINI("Physics", iPhysicsExitTicks)
+
 #undef READINI
 
 	logger::info("Finished loading .ini settings");
@@ -14,6 +14,8 @@ struct Settings
 	static void InitializeData();	// Post LoadData
 	static void Save();
 
+	static inline std::atomic<uint32_t> generation{ 0 };	// Incremented whenever settings change, for caches depending on them
+
 	// --- MCM
 	// Booleans
 	static inline bool bCreatureGender{ false };
@@ -101,8 +103,11 @@ struct Settings
 	// Animation
 	static inline uint32_t iFurniturePrefWeight{ 2 };	 // Weight ised in FindCenter() to use Furniture over default center. Chance = (1 / weight + 1)
 	static inline float fScanRadius{ 750.0f };				 // Radius used in FindCenter() in which to look for potential furniture refs
+	static inline uint32_t iFurnitureCandidates{ 1 };	 // Number of closest furniture FindCenter() randomly picks from, closer ones being more likely. 1 to always use the closest
 	static inline float fMinScale{ 0.88f };						 // Min Scale for an actor be animated
 	static inline bool bAllowDead{ false };						 // if dead actors are allowed in the framework
+	static inline float fClearanceCacheTime{ 300.0f };	 // Seconds the obstacle test around a furniture is reused before sampling it again, 0 to disable
+	static inline int32_t iClearanceRayBudget{ 0 };		 // Raycasts a single furniture may use to test its offsets for obstacles, 0 for no limit. Offsets left untested count as blocked
 
 	// Race
 	static inline bool bAshHopper{ true };
@@ -161,6 +166,8 @@ struct Settings
 	// --- Statistics
 	static inline float fPercentageHetero{ POPULATION_HETERO_DEFAULT };
 	static inline float fPercentageHomo{ POPULATION_HOMO_DEFAULT };
+	static inline int32_t iStatisticsBudget{ 512 };			// Memory (KiB) statistics may occupy before the least recently used generic (non unique) actors are dropped, 0 to disable
+	static inline float fEncounterRetention{ 90.0f };	// Game days after which encounters involving a generic actor are forgotten, 0 to disable
 
 	// --- Distances
 	static inline float fDistanceHead{ 14.7f };			 // distance from head node to lips = 9.3
@@ -171,6 +178,15 @@ struct Settings
 	static inline float fAngleGrinding{ 30.0f };	// angle for schlong and cortch to be considered "parallel"
 	static inline float fAngleMouth{ 30.0f };	 // Angle of the cone from headnode to schlong that interprets the schlong in front of mouth
 
+	// --- Physics
+	static inline bool bRecordPhysics{ false };	 // Write node transforms of every physics tick to a record file for offline replay
+	static inline int32_t iPhysicsIntervalMin{ 64 };		 // Shortest time between two physics ticks (ms), used while interactions change or nodes move fast. 64 = at most twice the former fixed rate of 128ms
+	static inline int32_t iPhysicsIntervalMax{ 256 };	 // Longest time between two physics ticks (ms), used while nothing moves
+	static inline float fPhysicsMaxStep{ 6.0f };				 // Distance a node or interaction may travel between two ticks before the tick rate is raised. Estimated, not measured: a ~10 unit thrust at ~1.5Hz peaks at ~0.047 units/ms = ~128ms
+	static inline bool bPhysicsBroadPhase{ true };			 // Skip detailed tests for pairs whose bounding spheres are out of reach of each other
+	static inline int32_t iPhysicsEnterTicks{ 2 };			 // Consecutive ticks an interaction has to be detected before it is reported
+	static inline int32_t iPhysicsExitTicks{ 3 };				 // Consecutive ticks an interaction has to be missing before it is no longer reported
+
 	// --- Misc
 	static inline std::vector<RE::FormID> SOS_ExcludeFactions{};
 
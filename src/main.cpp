@@ -1,4 +1,5 @@
 #include "Papyrus/Papyrus.h"
+#include "Registry/Define/Furniture.h"
 #include "Registry/Expression.h"
 #include "Registry/Library.h"
 #include "Registry/Stats.h"
@@ -127,6 +128,8 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 	serialization->SetFormDeleteCallback(Serialization::Serialize::FormDeleteCallback);
 
 	Registry::Statistics::StatisticsData::GetSingleton()->Register();
+	Registry::ClearanceCache::GetSingleton()->Register();
+	Registry::FurnitureIndex::GetSingleton()->Register();
 
 	logger::info("Initialization complete");
 
@@ -0,0 +1,152 @@
+#include "Check.h"
+#include "Registry/Util/CellGrid.h"
+
+namespace
+{
+	using CellGrid::CELL_SIZE;
+
+	struct Reference
+	{
+		float x;
+		float y;
+	};
+
+	// Square grid of loaded cells, as the engine's grid cell array, each holding the references placed in it
+	struct Grid
+	{
+		int32_t originX;
+		int32_t originY;
+		uint32_t length;
+		std::vector<std::vector<Reference>> cells;
+
+		Grid(int32_t a_originX, int32_t a_originY, uint32_t a_length) :
+			originX(a_originX), originY(a_originY), length(a_length), cells(a_length * a_length) {}
+
+		void Place(float a_x, float a_y)
+		{
+			const auto x = CellGrid::ToCell(a_x) - originX;
+			const auto y = CellGrid::ToCell(a_y) - originY;
+			if (x < 0 || y < 0 || x >= static_cast<int32_t>(length) || y >= static_cast<int32_t>(length))
+				return;
+			cells[x * length + y].push_back({ a_x, a_y });
+		}
+
+		size_t CountInRange(const std::vector<Reference>& a_cell, float a_x, float a_y, float a_radius) const
+		{
+			return std::ranges::count_if(a_cell, [&](const Reference& a_ref) {
+				return std::hypot(a_ref.x - a_x, a_ref.y - a_y) <= a_radius;
+			});
+		}
+
+		size_t Crawl(float a_x, float a_y, float a_radius, size_t& a_visited) const
+		{
+			size_t ret = 0;
+			a_visited = 0;
+			const auto range = CellGrid::GetOverlap(a_x, a_y, a_radius, originX, originY, length);
+			CellGrid::ForEach(range, [&](int32_t x, int32_t y) {
+				a_visited++;
+				ret += CountInRange(cells[x * length + y], a_x, a_y, a_radius);
+			});
+			return ret;
+		}
+
+		size_t Exhaustive(float a_x, float a_y, float a_radius) const
+		{
+			size_t ret = 0;
+			for (auto&& cell : cells) {
+				ret += CountInRange(cell, a_x, a_y, a_radius);
+			}
+			return ret;
+		}
+	};
+
+	void TestToCell()
+	{
+		CHECK(CellGrid::ToCell(0.0f) == 0);
+		CHECK(CellGrid::ToCell(CELL_SIZE - 0.5f) == 0);
+		CHECK(CellGrid::ToCell(CELL_SIZE) == 1);
+		CHECK(CellGrid::ToCell(-0.5f) == -1);
+		CHECK(CellGrid::ToCell(-CELL_SIZE) == -1);
+		CHECK(CellGrid::ToCell(-CELL_SIZE - 0.5f) == -2);
+	}
+
+	void TestOverlap()
+	{
+		// Circle inside a single cell of a grid centered on the origin
+		auto range = CellGrid::GetOverlap(100.0f, 100.0f, 50.0f, -2, -2, 5);
+		CHECK(range.xmin == 2 && range.xmax == 2 && range.ymin == 2 && range.ymax == 2);
+
+		// A boundary belongs to the cell above it, reaching it from below includes that cell
+		range = CellGrid::GetOverlap(CELL_SIZE - 100.0f, 100.0f, 100.0f, -2, -2, 5);
+		CHECK(range.xmin == 2 && range.xmax == 3);
+		range = CellGrid::GetOverlap(100.0f, 100.0f, 100.0f, -2, -2, 5);
+		CHECK(range.ymin == 2 && range.ymax == 2);
+		range = CellGrid::GetOverlap(100.0f, 100.0f, 100.5f, -2, -2, 5);
+		CHECK(range.ymin == 1 && range.ymax == 2);
+
+		// Negative coordinates
+		range = CellGrid::GetOverlap(-100.0f, -CELL_SIZE - 100.0f, 50.0f, -2, -2, 5);
+		CHECK(range.xmin == 1 && range.xmax == 1 && range.ymin == 0 && range.ymax == 0);
+
+		// Clamped to the edges of the grid
+		range = CellGrid::GetOverlap(0.0f, 0.0f, 10.0f * CELL_SIZE, -2, -2, 5);
+		CHECK(range.xmin == 0 && range.xmax == 4 && range.ymin == 0 && range.ymax == 4);
+		range = CellGrid::GetOverlap(2.5f * CELL_SIZE, 0.0f, 100.0f, -2, -2, 5);
+		CHECK(range.xmin == 4 && range.xmax == 4);
+
+		// Entirely outside of the grid
+		CHECK(CellGrid::GetOverlap(10.0f * CELL_SIZE, 0.0f, 100.0f, -2, -2, 5).IsEmpty());
+		CHECK(CellGrid::GetOverlap(0.0f, -10.0f * CELL_SIZE, 100.0f, -2, -2, 5).IsEmpty());
+		CHECK(!CellGrid::GetOverlap(0.0f, 0.0f, 0.0f, -2, -2, 5).IsEmpty());
+	}
+
+	void TestForEach()
+	{
+		std::vector<std::pair<int32_t, int32_t>> visited{};
+		CellGrid::ForEach({ 1, 2, 3, 4 }, [&](int32_t x, int32_t y) { visited.emplace_back(x, y); });
+		const std::vector<std::pair<int32_t, int32_t>> expected{ { 1, 3 }, { 1, 4 }, { 2, 3 }, { 2, 4 } };
+		CHECK(visited == expected);
+		size_t count = 0;
+		CellGrid::ForEach({ 2, 1, 0, 0 }, [&](int32_t, int32_t) { count++; });
+		CHECK(count == 0);
+	}
+
+	// The crawl finds every reference an exhaustive scan of all loaded cells finds, while visiting fewer cells
+	void TestSyntheticGrid()
+	{
+		Grid grid{ -3, 2, 5 };
+		const auto minX = grid.originX * CELL_SIZE;
+		const auto minY = grid.originY * CELL_SIZE;
+		const auto span = grid.length * CELL_SIZE;
+		// References on a lattice which includes points exactly on cell boundaries
+		constexpr uint32_t STEPS = 40;
+		for (uint32_t i = 0; i < STEPS; i++) {
+			for (uint32_t n = 0; n < STEPS; n++) {
+				grid.Place(minX + span * i / STEPS, minY + span * n / STEPS);
+			}
+		}
+		size_t visited = 0;
+		for (auto&& radius : { 0.0f, 256.0f, 1024.0f, CELL_SIZE, 3.0f * CELL_SIZE }) {
+			for (uint32_t i = 0; i <= 8; i++) {
+				for (uint32_t n = 0; n <= 8; n++) {
+					const auto x = minX - CELL_SIZE + (span + 2.0f * CELL_SIZE) * i / 8;
+					const auto y = minY - CELL_SIZE + (span + 2.0f * CELL_SIZE) * n / 8;
+					const auto found = grid.Crawl(x, y, radius, visited);
+					CHECK(found == grid.Exhaustive(x, y, radius));
+					CHECK(visited <= grid.cells.size());
+				}
+			}
+		}
+		grid.Crawl(minX + 2.5f * CELL_SIZE, minY + 2.5f * CELL_SIZE, 1024.0f, visited);
+		CHECK(visited == 1);
+	}
+}
+
+int main()
+{
+	TestToCell();
+	TestOverlap();
+	TestForEach();
+	TestSyntheticGrid();
+	return Check::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+/// Minimal assertion helpers, a test fails if any check fails
+namespace Check
+{
+	inline int failures = 0;
+
+	inline void Report(bool a_passed, const char* a_expression, const char* a_file, int a_line)
+	{
+		if (a_passed)
+			return;
+		failures++;
+		std::cerr << a_file << ":" << a_line << ": check failed: " << a_expression << "\n";
+	}
+
+	template <class F>
+	bool Throws(F&& a_func)
+	{
+		try {
+			a_func();
+		} catch (const std::exception&) {
+			return true;
+		}
+		return false;
+	}
+}	 // namespace Check
+
+#define CHECK(expression) Check::Report(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
@@ -0,0 +1,176 @@
+#include "Check.h"
+#include "Registry/Util/Clearance.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Axis aligned voxel grid around the world origin, rays march through it and stop at the first occupied voxel
+	class OccupancyGrid : public Clearance::RayCaster
+	{
+	public:
+		static constexpr float VOXEL{ 4.0f };
+		static constexpr int32_t SIZE{ 64 };	// voxels per axis
+		static constexpr float MIN{ -VOXEL * SIZE / 2 };
+		static constexpr float MARCH{ 1.0f };
+
+		OccupancyGrid() :
+			_voxels(SIZE * SIZE * SIZE) {}
+
+		void Fill(const glm::vec3& a_min, const glm::vec3& a_max)
+		{
+			for (int32_t x = Index(a_min.x); x <= Index(a_max.x); x++) {
+				for (int32_t y = Index(a_min.y); y <= Index(a_max.y); y++) {
+					for (int32_t z = Index(a_min.z); z <= Index(a_max.z); z++) {
+						if (InGrid(x, y, z))
+							_voxels[Flat(x, y, z)] = true;
+					}
+				}
+			}
+		}
+
+		Clearance::Hit Cast(const glm::vec4& a_from, const glm::vec4& a_to) override
+		{
+			casts++;
+			const auto length = glm::distance(a_from, a_to);
+			const auto steps = static_cast<int32_t>(std::ceil(length / MARCH));
+			for (int32_t i = 0; i <= steps; i++) {
+				const auto t = steps == 0 ? 0.0f : static_cast<float>(i) / steps;
+				const auto point = a_from + (a_to - a_from) * t;
+				if (IsOccupied(point))
+					return { true, point };
+			}
+			return {};
+		}
+
+		size_t casts{ 0 };
+
+	private:
+		static int32_t Index(float a_world) { return static_cast<int32_t>(std::floor((a_world - MIN) / VOXEL)); }
+		static bool InGrid(int32_t x, int32_t y, int32_t z) { return x >= 0 && y >= 0 && z >= 0 && x < SIZE && y < SIZE && z < SIZE; }
+		static size_t Flat(int32_t x, int32_t y, int32_t z) { return (static_cast<size_t>(x) * SIZE + y) * SIZE + z; }
+
+		bool IsOccupied(const glm::vec4& a_point) const
+		{
+			const auto x = Index(a_point.x), y = Index(a_point.y), z = Index(a_point.z);
+			return InGrid(x, y, z) && _voxels[Flat(x, y, z)];
+		}
+
+		std::vector<bool> _voxels;
+	};
+
+	struct Scene
+	{
+		OccupancyGrid grid{};
+		glm::vec3 center{ 0.0f, 0.0f, 0.0f };
+		glm::vec4 origin{ 0.0f, 0.0f, 40.0f, 0.0f };	// top of the furniture's bounding box
+	};
+
+	// Floor below the sample disc and a random set of obstacles, some scenes remain clear
+	Scene MakeScene(std::mt19937& a_rng)
+	{
+		Scene ret{};
+		ret.grid.Fill({ -128.0f, -128.0f, -16.0f }, { 127.0f, 127.0f, -1.0f });
+		std::uniform_int_distribution<int32_t> count{ 0, 4 };
+		std::uniform_real_distribution<float> position{ -56.0f, 56.0f };
+		std::uniform_real_distribution<float> extent{ 2.0f, 24.0f };
+		std::uniform_real_distribution<float> height{ 0.0f, 160.0f };
+		for (auto n = count(a_rng); n > 0; n--) {
+			const glm::vec3 min{ position(a_rng), position(a_rng), height(a_rng) };
+			ret.grid.Fill(min, min + glm::vec3{ extent(a_rng), extent(a_rng), extent(a_rng) });
+		}
+		return ret;
+	}
+
+	// The same sample points, row by row
+	std::vector<glm::vec2> GetRowOrder(std::vector<glm::vec2> a_points)
+	{
+		std::ranges::sort(a_points, [](const glm::vec2& a_lhs, const glm::vec2& a_rhs) {
+			return a_lhs.y != a_rhs.y ? a_lhs.y < a_rhs.y : a_lhs.x < a_rhs.x;
+		});
+		return a_points;
+	}
+
+	struct Run
+	{
+		std::vector<Clearance::Result> results{};
+		size_t casts{ 0 };
+		double us{ 0.0 };
+	};
+
+	Run TestAll(std::vector<Scene>& a_scenes, std::span<const glm::vec2> a_order)
+	{
+		Run ret{};
+		const auto t1 = Clock::now();
+		for (auto&& scene : a_scenes) {
+			scene.grid.casts = 0;
+			auto budget = std::numeric_limits<uint32_t>::max();
+			ret.results.push_back(Clearance::Test(scene.grid, scene.origin, scene.center, a_order, {}, budget));
+			ret.casts += scene.grid.casts;
+			CHECK(std::numeric_limits<uint32_t>::max() - budget == scene.grid.casts);
+		}
+		ret.us = std::chrono::duration<double, std::micro>(Clock::now() - t1).count();
+		return ret;
+	}
+
+	void TestOrder()
+	{
+		const Clearance::Params params{};
+		const auto order = Clearance::GetSampleOrder(params.radius, params.step);
+		CHECK(order.size() == 49);
+		CHECK(order.front() == glm::vec2(0.0f, 0.0f));
+		auto sorted = GetRowOrder(order);
+		CHECK(std::ranges::adjacent_find(sorted) == sorted.end());
+	}
+
+	void TestBudget()
+	{
+		const auto order = Clearance::GetSampleOrder(32.0f, 8.0f);
+		Scene scene{};
+		uint32_t budget = static_cast<uint32_t>(order.size() * 2 - 1);
+		CHECK(Clearance::Test(scene.grid, scene.origin, scene.center, order, {}, budget) == Clearance::Result::Unknown);
+		budget = static_cast<uint32_t>(order.size() * 2);
+		CHECK(Clearance::Test(scene.grid, scene.origin, scene.center, order, {}, budget) == Clearance::Result::Clear);
+		CHECK(budget == 0);
+
+		// An obstacle on the center is found within the first two casts, regardless of the remaining budget
+		scene.grid.Fill({ -2.0f, -2.0f, 60.0f }, { 2.0f, 2.0f, 64.0f });
+		budget = 2;
+		CHECK(Clearance::Test(scene.grid, scene.origin, scene.center, order, {}, budget) == Clearance::Result::Blocked);
+	}
+
+	// Coarse to fine and row order must agree on every scene, the benchmark reports how many casts each needs
+	void BenchOccupancyGrid()
+	{
+		constexpr size_t SCENES = 200;
+		std::mt19937 rng{ 1337 };
+		std::vector<Scene> scenes{};
+		scenes.reserve(SCENES);
+		for (size_t i = 0; i < SCENES; i++) {
+			scenes.push_back(MakeScene(rng));
+		}
+		const Clearance::Params params{};
+		const auto order = Clearance::GetSampleOrder(params.radius, params.step);
+		const auto rows = GetRowOrder(order);
+		const auto coarse = TestAll(scenes, order);
+		const auto linear = TestAll(scenes, rows);
+		CHECK(coarse.results == linear.results);
+		const auto clear = std::ranges::count(coarse.results, Clearance::Result::Clear);
+		CHECK(clear > 0 && clear < static_cast<std::ptrdiff_t>(SCENES));
+		CHECK(coarse.casts <= linear.casts);
+		// Clear scenes cast every ray in either order, only blocked scenes differ
+		const auto full = clear * order.size() * 2;
+		std::cout << std::fixed << std::setprecision(1)
+							<< SCENES << " scenes, " << clear << " clear\n"
+							<< "coarse to fine: " << coarse.casts << " casts (" << coarse.casts - full << " on blocked scenes), " << coarse.us << "us\n"
+							<< "row order:      " << linear.casts << " casts (" << linear.casts - full << " on blocked scenes), " << linear.us << "us\n";
+	}
+}
+
+int main()
+{
+	TestOrder();
+	TestBudget();
+	BenchOccupancyGrid();
+	return Check::failures == 0 ? 0 : 1;
+}
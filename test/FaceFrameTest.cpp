@@ -0,0 +1,115 @@
+#include "Check.h"
+#include "Registry/Util/FaceFrame.h"
+
+namespace
+{
+	using FaceFrame::Frame;
+
+	constexpr float EPSILON = 1e-5f;
+
+	bool Near(const Frame& a_lhs, const Frame& a_rhs)
+	{
+		for (size_t i = 0; i < FaceFrame::Total; i++) {
+			if (std::abs(a_lhs[i] - a_rhs[i]) > EPSILON)
+				return false;
+		}
+		return true;
+	}
+
+	// A level with every channel set to a_value, and the given mood
+	Frame MakeLevel(float a_value, float a_mood)
+	{
+		Frame ret{};
+		ret.fill(a_value);
+		ret[FaceFrame::MoodType] = a_mood;
+		return ret;
+	}
+
+	void TestLerp()
+	{
+		alignas(16) Frame base{};
+		alignas(16) Frame delta{};
+		for (size_t i = 0; i < FaceFrame::Total; i++) {
+			base[i] = static_cast<float>(i);
+			delta[i] = i % 2 ? 1.0f : -2.0f;
+		}
+		for (auto&& t : { 0.0f, 0.25f, 1.0f }) {
+			Frame out{};
+			FaceFrame::Lerp(base.data(), delta.data(), t, out.data());
+			Frame expected{};
+			for (size_t i = 0; i < FaceFrame::Total; i++) {
+				expected[i] = base[i] + t * delta[i];
+			}
+			CHECK(Near(out, expected));
+		}
+	}
+
+	void TestDiff()
+	{
+		Frame current{};
+		auto target = current;
+		CHECK(FaceFrame::Diff(current, target, 0.01f).none());
+
+		// Changes within epsilon are not written
+		target[FaceFrame::Phoneme + 2] = 0.005f;
+		target[FaceFrame::Modifier + 1] = 0.5f;
+		auto changed = FaceFrame::Diff(current, target, 0.01f);
+		CHECK(!changed[FaceFrame::Phoneme + 2]);
+		CHECK(changed[FaceFrame::Modifier + 1]);
+		CHECK(changed.count() == 1);
+		CHECK(FaceFrame::Diff(current, target, 0.0f)[FaceFrame::Phoneme + 2]);
+
+		// Mood type and value are set together, a change to either reports both
+		target = current;
+		target[FaceFrame::MoodValue] = 0.5f;
+		changed = FaceFrame::Diff(current, target, 0.01f);
+		CHECK(changed[FaceFrame::MoodType] && changed[FaceFrame::MoodValue]);
+		CHECK(changed.count() == 2);
+		target = current;
+		target[FaceFrame::MoodType] = 4.0f;
+		changed = FaceFrame::Diff(current, target, 0.01f);
+		CHECK(changed[FaceFrame::MoodType] && changed[FaceFrame::MoodValue]);
+		CHECK(changed.count() == 2);
+	}
+
+	void TestCurve()
+	{
+		const std::vector<Frame> levels{ MakeLevel(0.0f, 3.0f), MakeLevel(0.4f, 8.0f), MakeLevel(1.0f, 9.0f) };
+		const FaceFrame::Curve curve{ levels };
+		CHECK(!curve.IsEmpty());
+		// Intensity 0 and 1 land on the first and last level, values outside are clamped
+		CHECK(Near(curve.Evaluate(0.0f), levels[0]));
+		CHECK(Near(curve.Evaluate(1.0f), levels[2]));
+		CHECK(Near(curve.Evaluate(-1.0f), levels[0]));
+		CHECK(Near(curve.Evaluate(2.0f), levels[2]));
+		CHECK(Near(curve.Evaluate(0.5f), levels[1]));
+
+		// A quarter is halfway between the first two levels, the mood type snaps to the closer one
+		const auto quarter = curve.Evaluate(0.25f);
+		CHECK(std::abs(quarter[FaceFrame::Phoneme] - 0.2f) < EPSILON);
+		CHECK(std::abs(quarter[FaceFrame::MoodValue] - 0.2f) < EPSILON);
+		CHECK(quarter[FaceFrame::MoodType] == 8.0f);
+		CHECK(curve.Evaluate(0.2f)[FaceFrame::MoodType] == 3.0f);
+		CHECK(curve.Evaluate(0.9f)[FaceFrame::MoodType] == 9.0f);
+		CHECK(curve.Evaluate(0.6f)[FaceFrame::MoodType] == 8.0f);
+
+		// A single level is returned for every intensity
+		const std::vector<Frame> single{ MakeLevel(0.7f, 5.0f) };
+		const FaceFrame::Curve flat{ single };
+		for (auto&& intensity : { 0.0f, 0.3f, 1.0f }) {
+			CHECK(Near(flat.Evaluate(intensity), single[0]));
+		}
+
+		const FaceFrame::Curve empty{};
+		CHECK(empty.IsEmpty());
+		CHECK(Near(empty.Evaluate(0.5f), Frame{}));
+	}
+}
+
+int main()
+{
+	TestLerp();
+	TestDiff();
+	TestCurve();
+	return Check::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include "Check.h"
+#include "Registry/Util/InteractionRecord.h"
+
+namespace
+{
+	using Interaction::NodeFrame;
+	using Interaction::TypeData;
+
+	constexpr uint32_t GIVER = 0x14;
+	constexpr uint32_t RECEIVER = 0xFF000D62;
+
+	Interaction::Transform At(float a_x, float a_y, float a_z)
+	{
+		Interaction::Transform ret{};
+		ret.translate = { a_x, a_y, a_z };
+		return ret;
+	}
+
+	// Two female bodies facing each other, the giver's left hand at a_gap units from the receiver's clitoris
+	std::vector<NodeFrame> MakeFrames(float a_gap)
+	{
+		std::vector<NodeFrame> ret(2);
+		auto& receiver = ret[0];
+		receiver.Set(NodeFrame::Pelvis, At(0.0f, 0.0f, 100.0f));
+		receiver.Set(NodeFrame::SpineLower, At(0.0f, -5.0f, 100.0f));
+		receiver.Set(NodeFrame::Clitoris, At(0.0f, 3.0f, 95.0f));
+		auto& giver = ret[1];
+		giver.Set(NodeFrame::Pelvis, At(0.0f, 40.0f, 100.0f));
+		giver.Set(NodeFrame::SpineLower, At(0.0f, 45.0f, 100.0f));
+		giver.Set(NodeFrame::Clitoris, At(0.0f, 43.0f, 95.0f));
+		giver.Set(NodeFrame::HandLeft, At(0.0f, 3.0f + a_gap, 95.0f));
+		return ret;
+	}
+
+	void WriteRecord(const fs::path& a_file, const std::vector<float>& a_gaps)
+	{
+		std::ofstream stream{ a_file, std::ios::binary | std::ios::trunc };
+		Interaction::Record::WriteHeader(stream, { 32, { { RECEIVER, Interaction::SexFlag::Female }, { GIVER, Interaction::SexFlag::Female } } });
+		for (size_t i = 0; i < a_gaps.size(); i++) {
+			Interaction::Record::WriteTick(stream, MakeFrames(a_gaps[i]), static_cast<float>(i * 32));
+		}
+	}
+
+	std::vector<std::string> ReadLines(const fs::path& a_file)
+	{
+		std::vector<std::string> ret{};
+		std::ifstream stream{ a_file };
+		for (std::string line; std::getline(stream, line);) {
+			ret.push_back(line);
+		}
+		return ret;
+	}
+
+	void TestClassification()
+	{
+		const auto frames = MakeFrames(2.0f);
+		const std::vector<TypeData> none{};
+		std::vector<Interaction::Body> bodies{};
+		bodies.emplace_back(RECEIVER, Interaction::SexFlag::Female, frames[0], none);
+		bodies.emplace_back(GIVER, Interaction::SexFlag::Female, frames[1], none);
+		std::vector<double> pairtimes{};
+		const auto skipped = Interaction::Evaluate(bodies, {}, true, &pairtimes);
+		CHECK(skipped == 0);
+		CHECK(pairtimes.size() == 2);
+		CHECK(bodies[0].types.size() == 1);
+		CHECK(bodies[0].types[0]._type == TypeData::Type::Hand);
+		CHECK(bodies[0].types[0]._partner == GIVER);
+		CHECK(std::abs(bodies[0].types[0]._distance - 2.0f) < 1e-4f);
+		CHECK(bodies[1].types.empty());
+
+		// Far enough apart for the broad phase to reject both orderings
+		auto distant = frames;
+		for (auto&& transform : distant[1].world) {
+			transform.translate.y += 1000.0f;
+		}
+		std::vector<Interaction::Body> apart{};
+		apart.emplace_back(RECEIVER, Interaction::SexFlag::Female, distant[0], none);
+		apart.emplace_back(GIVER, Interaction::SexFlag::Female, distant[1], none);
+		CHECK(Interaction::Evaluate(apart, {}, true) == 2);
+		CHECK(apart[0].types.empty() && apart[1].types.empty());
+	}
+
+	void TestReplay()
+	{
+		const auto file = fs::current_path() / "interaction_test.slpr";
+		auto golden = file;
+		golden.replace_extension(".golden");
+		// Contact in ticks 0-3, then released; reported after 2 ticks and dropped after 3
+		WriteRecord(file, { 2.0f, 2.0f, 2.0f, 2.0f, 30.0f, 30.0f, 30.0f, 30.0f });
+
+		const auto made = Interaction::Record::Replay(file, true, {});
+		CHECK(made.ticks == 8);
+		CHECK(made.positions == 2);
+		CHECK(!made.truncated);
+		CHECK(made.mismatches == 0);
+		const auto lines = ReadLines(golden);
+		CHECK(lines.size() == 8);
+		if (lines.size() == 8) {
+			CHECK(lines[0].empty());
+			CHECK(lines[1] == "FF000D62 14 6");
+			CHECK(lines[5] == "FF000D62 14 6");
+			CHECK(lines[6].empty());
+		}
+
+		const auto again = Interaction::Record::Replay(file, false, {});
+		CHECK(again.mismatches == 0);
+
+		// A record whose contact is never released differs from the golden output in its last ticks
+		WriteRecord(file, { 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f });
+		const auto changed = Interaction::Record::Replay(file, false, {});
+		CHECK(changed.mismatches == 2);
+
+		// A partially written tick is reported, not treated as an error
+		{
+			std::ofstream stream{ file, std::ios::binary | std::ios::app };
+			const float timestamp = 1000.0f;
+			stream.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+		}
+		const auto truncated = Interaction::Record::Replay(file, false, {});
+		CHECK(truncated.truncated);
+		CHECK(truncated.ticks == 8);
+
+		fs::remove(file);
+		fs::remove(golden);
+		fs::remove(fs::path{ file }.replace_extension(".report"));
+	}
+
+	void TestInvalidHeader()
+	{
+		const auto file = fs::current_path() / "interaction_invalid.slpr";
+		const auto replay = [&]() { Interaction::Record::Replay(file, false, {}); };
+		{
+			// Claims more positions than the record holds
+			std::ofstream stream{ file, std::ios::binary | std::ios::trunc };
+			for (auto&& value : { Interaction::Record::MAGIC, Interaction::Record::VERSION, 32u, 4u }) {
+				stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+		}
+		CHECK(Check::Throws(replay));
+		{
+			// Header ends before the position count
+			std::ofstream stream{ file, std::ios::binary | std::ios::trunc };
+			for (auto&& value : { Interaction::Record::MAGIC, Interaction::Record::VERSION }) {
+				stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+		}
+		CHECK(Check::Throws(replay));
+		{
+			std::ofstream stream{ file, std::ios::binary | std::ios::trunc };
+			stream << "not a record";
+		}
+		CHECK(Check::Throws(replay));
+		fs::remove(file);
+		CHECK(Check::Throws(replay));
+	}
+}
+
+int main()
+{
+	TestClassification();
+	TestReplay();
+	TestInvalidHeader();
+	return Check::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Host replacement of src/PCH.h, only the standard library and glm are available to the code under test
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <xmmintrin.h>
+
+#include <glm/glm.hpp>
+
+#ifndef _NODISCARD
+#define _NODISCARD [[nodiscard]]
+#endif
+
+namespace fs = std::filesystem;
+using namespace std::literals;
@@ -0,0 +1,24 @@
+#include "Registry/Util/InteractionRecord.h"
+
+// Replays a physics record written by the plugin (bRecordPhysics) and writes its report next to it
+// Usage: PhysicsReplay <record.slpr> [--golden]
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <record.slpr> [--golden]\n";
+		return 2;
+	}
+	const fs::path file{ argv[1] };
+	const bool makegolden = argc > 2 && std::string_view{ argv[2] } == "--golden";
+	try {
+		const auto summary = Interaction::Record::Replay(file, makegolden, {});
+		if (summary.truncated) {
+			std::cerr << "Record " << file.filename().string() << " is truncated after " << summary.ticks << " ticks\n";
+		}
+		std::cout << file.filename().string() << ": " << summary.ToString() << "\n";
+		return summary.mismatches == 0 ? 0 : 1;
+	} catch (const std::exception& e) {
+		std::cerr << "Unable to replay physics record " << file.string() << ", Error: " << e.what() << "\n";
+		return 2;
+	}
+}
@@ -0,0 +1,232 @@
+#include "Check.h"
+#include "Registry/Util/NodeNames.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using NodeNames::NodeFrame;
+
+	struct Node
+	{
+		std::string name;
+		std::vector<Node*> children;
+	};
+
+	class Tree
+	{
+	public:
+		Tree() { _nodes.push_back(std::make_unique<Node>("NPC Root [Root]")); }
+
+		Node* Root() const { return _nodes.front().get(); }
+		size_t Size() const { return _nodes.size(); }
+		Node* At(size_t a_idx) const { return _nodes[a_idx].get(); }
+
+		Node* Add(Node* a_parent, std::string_view a_name)
+		{
+			auto& node = _nodes.emplace_back(std::make_unique<Node>(std::string{ a_name }));
+			a_parent->children.push_back(node.get());
+			return node.get();
+		}
+
+	private:
+		std::vector<std::unique_ptr<Node>> _nodes;
+	};
+
+	// Depth first, as the engine's scene graph visitor, counts every visited node
+	struct Traversal
+	{
+		size_t visited{ 0 };
+
+		template <class F>
+		bool operator()(Node* a_node, F&& a_visit)
+		{
+			visited++;
+			if (a_visit(a_node, std::string_view{ a_node->name }))
+				return true;
+			for (auto&& child : a_node->children) {
+				if ((*this)(child, a_visit))
+					return true;
+			}
+			return false;
+		}
+	};
+
+	bool EqualsNoCase(std::string_view a_lhs, std::string_view a_rhs)
+	{
+		return std::ranges::equal(a_lhs, a_rhs, [](char a, char b) { return std::tolower(static_cast<uint8_t>(a)) == std::tolower(static_cast<uint8_t>(b)); });
+	}
+
+	// One traversal per name, like GetObjectByName
+	Node* FindByName(Node* a_root, std::string_view a_name, size_t& a_visited)
+	{
+		Traversal traversal{};
+		Node* ret = nullptr;
+		traversal(a_root, [&](Node* a_node, std::string_view a_nodename) {
+			if (!EqualsNoCase(a_nodename, a_name))
+				return false;
+			ret = a_node;
+			return true;
+		});
+		a_visited += traversal.visited;
+		return ret;
+	}
+
+	// Node lookup as done before the table, each body node by name, then each schlong candidate in priority order until one is found
+	template <size_t A, size_t B, size_t C>
+	std::array<Node*, NodeFrame::Total> ResolveByName(Node* a_root,
+		const std::array<std::string_view, A>& a_start, const std::array<std::string_view, B>& a_mid, const std::array<std::string_view, C>& a_tip, size_t& a_visited)
+	{
+		std::array<Node*, NodeFrame::Total> ret{};
+		for (auto&& key : NodeNames::BODY) {
+			ret[key.slot] = FindByName(a_root, key.name, a_visited);
+		}
+		const auto first = [&](auto& a_names) -> Node* {
+			for (auto&& name : a_names) {
+				if (const auto node = FindByName(a_root, name, a_visited))
+					return node;
+			}
+			return nullptr;
+		};
+		ret[NodeFrame::SosBase] = first(a_start);
+		ret[NodeFrame::SosMid] = first(a_mid);
+		ret[NodeFrame::SosFront] = first(a_tip);
+		return ret;
+	}
+
+	auto ResolveDefault(Node* a_root, size_t& a_visited)
+	{
+		Traversal traversal{};
+		const auto ret = NodeNames::DEFAULT_NODES.Resolve(a_root, traversal);
+		a_visited += traversal.visited;
+		return ret;
+	}
+
+	// A skeleton of a_size nodes, each attached to a random earlier node, with every body node and a few schlong candidates per slot
+	Tree MakeTree(std::mt19937& a_rng, size_t a_size)
+	{
+		Tree ret{};
+		for (size_t i = 1; i < a_size; i++) {
+			std::uniform_int_distribution<size_t> parent{ 0, ret.Size() - 1 };
+			ret.Add(ret.At(parent(a_rng)), "Node " + std::to_string(i));
+		}
+		std::uniform_int_distribution<size_t> target{ 1, a_size - 1 };
+		std::vector<std::string_view> names{};
+		for (auto&& key : NodeNames::BODY) {
+			names.push_back(key.name);
+		}
+		const auto sample = [&](auto& a_names) {
+			std::uniform_int_distribution<size_t> count{ 0, 3 };
+			std::vector<std::string_view> pool{ a_names.begin(), a_names.end() };
+			std::ranges::shuffle(pool, a_rng);
+			for (auto n = count(a_rng); n > 0 && !pool.empty(); n--) {
+				if (std::ranges::find(names, pool.back()) == names.end())
+					names.push_back(pool.back());
+				pool.pop_back();
+			}
+		};
+		sample(NodeNames::SOSSTART);
+		sample(NodeNames::SOSMID);
+		sample(NodeNames::SOSTIP);
+		for (auto&& name : names) {
+			ret.At(target(a_rng))->name = name;
+		}
+		return ret;
+	}
+
+	Node* Chain(Tree& a_tree, std::initializer_list<std::string_view> a_names)
+	{
+		auto node = a_tree.Root();
+		for (auto&& name : a_names) {
+			node = a_tree.Add(node, name);
+		}
+		return node;
+	}
+
+	void TestPriority()
+	{
+		size_t visited = 0;
+		// Only the lowest priority candidates, "RD" is also used by actors with two schlongs
+		Tree tree{};
+		const auto base = Chain(tree, { "Node 1", "RD 2" });
+		const auto mid = Chain(tree, { "rd 3" });
+		const auto tip = Chain(tree, { "Node 2", "Node 3", "RD 5" });
+		auto nodes = ResolveDefault(tree.Root(), visited);
+		CHECK(nodes[NodeFrame::SosBase] == base && nodes[NodeFrame::SosMid] == mid && nodes[NodeFrame::SosFront] == tip);
+		CHECK(!nodes[NodeFrame::Head] && !nodes[NodeFrame::Pelvis]);
+		Traversal traversal{};
+		nodes = NodeNames::ALTERNATE_NODES.Resolve(tree.Root(), traversal);
+		CHECK(nodes[NodeFrame::SosBase] == base && nodes[NodeFrame::SosMid] == mid && nodes[NodeFrame::SosFront] == tip);
+
+		// A better candidate later in the traversal replaces an earlier one, a worse one does not
+		const auto creature = Chain(tree, { "Node 4", "AH Base" });
+		const auto genitals = Chain(tree, { "Node 5", "Node 6", "NPC Genitals01 [Gen01]" });
+		Chain(tree, { "DD 2" });
+		nodes = ResolveDefault(tree.Root(), visited);
+		CHECK(nodes[NodeFrame::SosBase] == genitals);
+		CHECK(nodes[NodeFrame::SosMid] == mid);
+		nodes = NodeNames::ALTERNATE_NODES.Resolve(tree.Root(), traversal);
+		CHECK(nodes[NodeFrame::SosBase] == base);
+		genitals->name = "Node 7";
+		nodes = ResolveDefault(tree.Root(), visited);
+		CHECK(nodes[NodeFrame::SosBase] == creature);
+
+		// The traversal stops once every slot holds its preferred node
+		Tree complete{};
+		std::vector<std::string_view> preferred{};
+		for (auto&& key : NodeNames::BODY) {
+			preferred.push_back(key.name);
+		}
+		preferred.push_back(NodeNames::SOSSTART.front());
+		preferred.push_back(NodeNames::SOSMID.front());
+		preferred.push_back(NodeNames::SOSTIP.front());
+		for (auto&& name : preferred) {
+			complete.Add(complete.Root(), name);
+		}
+		for (size_t i = 0; i < 100; i++) {
+			complete.Add(complete.Root(), "Node " + std::to_string(i));
+		}
+		Traversal counted{};
+		nodes = NodeNames::DEFAULT_NODES.Resolve(complete.Root(), counted);
+		CHECK(std::ranges::none_of(nodes, [](Node* a_node) { return a_node == nullptr; }));
+		CHECK(counted.visited == preferred.size() + 1);
+	}
+
+	// The table resolves the same nodes as one traversal per name on random skeletons, the benchmark reports both
+	void BenchSkeleton()
+	{
+		constexpr size_t TREES = 50;
+		constexpr size_t NODES = 4000;
+		std::mt19937 rng{ 1337 };
+		std::vector<Tree> trees{};
+		trees.reserve(TREES);
+		for (size_t i = 0; i < TREES; i++) {
+			trees.push_back(MakeTree(rng, NODES));
+		}
+		size_t byname = 0, table = 0;
+		std::vector<std::array<Node*, NodeFrame::Total>> expected{}, resolved{};
+		const auto t1 = Clock::now();
+		for (auto&& tree : trees) {
+			expected.push_back(ResolveByName(tree.Root(), NodeNames::SOSSTART, NodeNames::SOSMID, NodeNames::SOSTIP, byname));
+		}
+		const auto t2 = Clock::now();
+		for (auto&& tree : trees) {
+			resolved.push_back(ResolveDefault(tree.Root(), table));
+		}
+		const auto t3 = Clock::now();
+		CHECK(resolved == expected);
+		CHECK(table <= TREES * NODES);
+		CHECK(table < byname);
+		const auto us = [](auto a_duration) { return std::chrono::duration<double, std::micro>(a_duration).count() / TREES; };
+		std::cout << std::fixed << std::setprecision(1)
+							<< TREES << " trees of " << NODES << " nodes\n"
+							<< "by name: " << byname / TREES << " nodes visited, " << us(t2 - t1) << "us per tree\n"
+							<< "table:   " << table / TREES << " nodes visited, " << us(t3 - t2) << "us per tree\n";
+	}
+}
+
+int main()
+{
+	TestPriority();
+	BenchSkeleton();
+	return Check::failures == 0 ? 0 : 1;
+}
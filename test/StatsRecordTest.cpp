@@ -0,0 +1,220 @@
+#include "Check.h"
+#include "Registry/Util/StatsRecord.h"
+
+namespace
+{
+	using StatsRecord::Encounter;
+	using StatsRecord::Record;
+	using StatsRecord::Statistics;
+
+	constexpr size_t COLUMNS = 18;	// ActorStats::Total
+
+	// In memory stand-in for the SKSE serialization interface, a single record
+	class SerializationInterface
+	{
+	public:
+		uint32_t WriteRecordData(const void* a_buf, uint32_t a_length)
+		{
+			const auto bytes = static_cast<const std::byte*>(a_buf);
+			_data.insert(_data.end(), bytes, bytes + a_length);
+			return a_length;
+		}
+		template <class T>
+		uint32_t WriteRecordData(const T& a_buf)
+		{
+			return WriteRecordData(std::addressof(a_buf), sizeof(T));
+		}
+
+		uint32_t ReadRecordData(void* a_buf, uint32_t a_length)
+		{
+			const auto size = static_cast<uint32_t>(std::min<size_t>(a_length, _data.size() - _read));
+			std::memcpy(a_buf, _data.data() + _read, size);
+			_read += size;
+			return size;
+		}
+		template <class T>
+		uint32_t ReadRecordData(T& a_buf)
+		{
+			return ReadRecordData(std::addressof(a_buf), sizeof(T));
+		}
+
+		uint32_t GetLength() const { return static_cast<uint32_t>(_data.size()); }
+		void Truncate(size_t a_size) { _data.resize(a_size); }
+
+	private:
+		std::vector<std::byte> _data{};
+		size_t _read{ 0 };
+	};
+
+	// The version 1 writer: size_t counts, an int tag and the custom value variant stored as raw bytes
+	void WriteString(SerializationInterface& a_intfc, const std::string& a_str)
+	{
+		const size_t size = a_str.size() + 1;
+		a_intfc.WriteRecordData(size);
+		a_intfc.WriteRecordData(a_str.c_str(), static_cast<uint32_t>(size));
+	}
+
+	void WriteLegacy(SerializationInterface& a_intfc, const std::vector<Statistics>& a_statistics)
+	{
+		a_intfc.WriteRecordData(a_statistics.size());
+		for (auto&& entry : a_statistics) {
+			a_intfc.WriteRecordData(entry.id);
+			for (auto&& value : entry.values) {
+				a_intfc.WriteRecordData(value);
+			}
+			a_intfc.WriteRecordData(entry.custom.size());
+			for (auto&& [key, value] : entry.custom) {
+				WriteString(a_intfc, key);
+				a_intfc.WriteRecordData(static_cast<int>(value.index()));
+				if (std::holds_alternative<float>(value)) {
+					// The float, then whatever the rest of the variant held
+					std::array<std::byte, StatsRecord::LEGACY_VARIANT_SIZE> raw{};
+					raw.fill(std::byte{ 0xCD });
+					const auto flt = std::get<float>(value);
+					std::memcpy(raw.data(), &flt, sizeof(flt));
+					a_intfc.WriteRecordData(raw.data(), static_cast<uint32_t>(raw.size()));
+				} else {
+					WriteString(a_intfc, std::get<std::string>(value));
+				}
+			}
+		}
+	}
+
+	Statistics MakeStatistics(uint32_t a_id, float a_seed)
+	{
+		Statistics ret{ a_id, std::vector<float>(COLUMNS), {} };
+		for (size_t i = 0; i < COLUMNS; i++) {
+			ret.values[i] = i % 3 == 0 ? 0.0f : a_seed * static_cast<float>(i);
+		}
+		return ret;
+	}
+
+	// Forms from plugin 0x05 were removed from the load order, everything else keeps its id
+	std::optional<uint32_t> Resolve(uint32_t a_id)
+	{
+		if ((a_id >> 24) == 0x05)
+			return std::nullopt;
+		return a_id;
+	}
+
+	bool Equal(const Statistics& a_lhs, const Statistics& a_rhs)
+	{
+		return a_lhs.id == a_rhs.id && a_lhs.values == a_rhs.values && a_lhs.custom == a_rhs.custom;
+	}
+
+	bool Equal(const Encounter& a_lhs, const Encounter& a_rhs)
+	{
+		if (a_lhs.history.size() != a_rhs.history.size())
+			return false;
+		for (size_t i = 0; i < a_lhs.history.size(); i++) {
+			if (std::abs(a_lhs.history[i].time - a_rhs.history[i].time) > 1e-4f || a_lhs.history[i].type != a_rhs.history[i].type)
+				return false;
+		}
+		return a_lhs.npc1 == a_rhs.npc1 && a_lhs.npc2 == a_rhs.npc2 &&
+					 a_lhs.race1 == a_rhs.race1 && a_lhs.race2 == a_rhs.race2 &&
+					 a_lhs.sex1 == a_rhs.sex1 && a_lhs.sex2 == a_rhs.sex2 &&
+					 a_lhs.lastmet == a_rhs.lastmet && a_lhs.timesmet == a_rhs.timesmet &&
+					 a_lhs.timessubmissive == a_rhs.timessubmissive && a_lhs.timesdominant == a_rhs.timesdominant &&
+					 a_lhs.timesvictim == a_rhs.timesvictim && a_lhs.timesaggressor == a_rhs.timesaggressor;
+	}
+
+	bool Equal(const Record& a_lhs, const Record& a_rhs)
+	{
+		return std::ranges::equal(a_lhs.statistics, a_rhs.statistics, [](auto& a, auto& b) { return Equal(a, b); }) &&
+					 std::ranges::equal(a_lhs.encounters, a_rhs.encounters, [](auto& a, auto& b) { return Equal(a, b); });
+	}
+
+	Record RoundTrip(const Record& a_record)
+	{
+		std::vector<std::byte> buffer{};
+		StatsRecord::Serialize(a_record, COLUMNS, buffer);
+		return StatsRecord::Deserialize(buffer, 3, Resolve);
+	}
+
+	// A legacy record is read in its written layout and survives being saved again in the current format
+	void TestLegacy()
+	{
+		auto player = MakeStatistics(0x14, 1.5f);
+		player.custom.emplace_back("sslFavoriteAnimation", std::string{ "Missionary" });
+		player.custom.emplace_back("sslOrgasms", 12.25f);
+		auto removed = MakeStatistics(0x05000D62, 2.0f);
+		removed.custom.emplace_back("sslOrgasms", 3.0f);
+		auto npc = MakeStatistics(0x0001A694, 0.5f);
+		npc.custom.emplace_back("", std::string{});
+		npc.custom.emplace_back("sslLastPartner", std::string{ "Lydia" });
+		// Unsorted as the legacy store was a hash map
+		SerializationInterface intfc{};
+		WriteLegacy(intfc, { npc, removed, player });
+
+		const auto legacy = StatsRecord::ReadLegacy(intfc, intfc.GetLength(), COLUMNS, Resolve);
+		const Record expected{ { player, npc }, {} };
+		CHECK(Equal(legacy, expected));
+		CHECK(Equal(RoundTrip(legacy), expected));
+
+		// The record ends early, or claims more entries than it holds
+		for (auto&& length : { size_t{ 0 }, size_t{ 7 }, size_t{ intfc.GetLength() - 1u } }) {
+			SerializationInterface truncated{};
+			WriteLegacy(truncated, { npc, removed, player });
+			truncated.Truncate(length);
+			CHECK(Check::Throws([&] { (void)StatsRecord::ReadLegacy(truncated, truncated.GetLength(), COLUMNS, Resolve); }));
+		}
+		SerializationInterface overlong{};
+		WriteLegacy(overlong, { npc });
+		CHECK(Check::Throws([&] { (void)StatsRecord::ReadLegacy(overlong, overlong.GetLength() - 1u, COLUMNS, Resolve); }));
+	}
+
+	void TestCurrent()
+	{
+		Record record{};
+		record.statistics.push_back(MakeStatistics(0x14, 1.0f));
+		record.statistics.push_back(MakeStatistics(0x0001A694, 0.25f));
+		record.statistics.push_back(MakeStatistics(0x05000D62, 4.0f));
+		record.statistics[0].custom.emplace_back("sslOrgasms", -0.0f);
+		record.statistics[0].custom.emplace_back("sslLastPartner", std::string{ "Lydia" });
+		record.statistics[1].custom.emplace_back("sslLastPartner", std::string{ "sslOrgasms" });
+		record.statistics[1].values[1] = -7.0f;
+
+		Encounter encounter{ 0x14, 0x0001A694, 3, 4, 0, 1, 120.5f, 5, 1, 2, 0, 1, {} };
+		// Whole game minutes, oldest first
+		for (int i = 4; i >= 0; i--) {
+			encounter.history.emplace_back(encounter.lastmet - static_cast<float>(i * 90) / 1440.0f, static_cast<uint8_t>(i % 5));
+		}
+		record.encounters.push_back(encounter);
+		record.encounters.push_back({ 0x14, 0x05000D62, 1, 1, 1, 1, 3.0f, 1, 0, 0, 0, 0, { { 3.0f, 0 } } });
+		record.encounters.push_back({ 0x0001A694, 0x00013BBF, 0, 0, 0, 0, 0.0f, 255, 255, 0, 0, 0, {} });
+
+		Record expected = record;
+		expected.statistics.pop_back();
+		expected.encounters.erase(expected.encounters.begin() + 1);
+		CHECK(Equal(RoundTrip(record), expected));
+		CHECK(Equal(RoundTrip(RoundTrip(record)), expected));
+
+		// Version 2 records end before the history, which is a size column of all zeroes without entries
+		auto nohistory = record;
+		for (auto&& enc : nohistory.encounters) {
+			enc.history.clear();
+		}
+		std::vector<std::byte> buffer{};
+		StatsRecord::Serialize(nohistory, COLUMNS, buffer);
+		const auto v2 = StatsRecord::Deserialize(std::span{ buffer }.first(buffer.size() - record.encounters.size()), 2, Resolve);
+		for (auto&& enc : expected.encounters) {
+			enc.history.clear();
+		}
+		CHECK(Equal(v2, expected));
+
+		// An empty store still writes every column
+		Record empty{};
+		buffer.clear();
+		StatsRecord::Serialize(empty, COLUMNS, buffer);
+		CHECK(buffer.size() == 1 + 1 + COLUMNS + 1 + 1);
+		CHECK(Equal(StatsRecord::Deserialize(buffer, 3, Resolve), empty));
+		CHECK(Check::Throws([&] { (void)StatsRecord::Deserialize(std::span{ buffer }.first(3), 3, Resolve); }));
+	}
+}
+
+int main()
+{
+	TestLegacy();
+	TestCurrent();
+	return Check::failures == 0 ? 0 : 1;
+}